@@ -274,6 +274,17 @@ function linkEdges(h1, h2) {
     h2.pair = h1;
 }
 
+/**
+ * Whether the loaded solver module has all of the named entry points. The
+ * blossom.js and blossom.wasm checked in predate the typed array bindings and
+ * only have blossom() and hamiltonianCycle(); every other path below falls back
+ * to those until the module is rebuilt with emcc, see CMakeLists.txt
+ * @param {...string} names Entry points as registered in wasm/bindings.cpp
+ */
+function solverHas(...names) {
+    return names.every(name => Module[name] !== undefined);
+}
+
 
 ///////////////////////////////////////////////////
 //               MAIN MESH CLASS                 //
@@ -618,14 +629,7 @@ class HedgeMesh extends PolyMesh {
      * @returns {'nodes': List of node objects, 'edges':List of edge objects}
      */
     getDualGraph(){
-        let nodes = [];
-        for (let i = 0; i < this.faces.length; i++){
-            let current = this.faces[i];
-            let center = current.getCentroid();
-            let nodei = new Node(i,center);
-            this.faces[i].centroid = nodei;
-            nodes.push(nodei);
-        }
+        let nodes = this.getDualNodes();
         let edgeSet = new Set();
         let edges = [];
 
@@ -648,6 +652,42 @@ class HedgeMesh extends PolyMesh {
         return {"nodes":nodes, "edges":edges};
     }
 
+    /**
+     * One node per face at its centroid, without any edges yet
+     */
+    getDualNodes() {
+        let nodes = [];
+        for (let i = 0; i < this.faces.length; i++){
+            let current = this.faces[i];
+            let center = current.getCentroid();
+            let nodei = new Node(i,center);
+            this.faces[i].centroid = nodei;
+            nodes.push(nodei);
+        }
+        return nodes;
+    }
+
+    /**
+     * Hand the triangle index buffer to the solver, which builds the dual graph
+     * itself. Only triangle meshes qualify, where face i is triangle i
+     * @param {string} solve The triangle entry point the caller goes on to use
+     * @returns {boolean} false if the mesh has other faces or the module predates
+     *          the triangle entry points, nothing is written then
+     */
+    nativeDualInput(solve) {
+        if (!solverHas("triangleInputView", "MatchingEngine", solve)) {
+            return false;
+        }
+
+        const triangles = this.getTriangleIndices();
+        if (triangles.length != 3 * this.faces.length) {
+            return false;
+        }
+
+        Module["triangleInputView"](triangles.length).set(triangles);
+        return true;
+    }
+
     redoNeighbors(nodes, edges) {
         for (let i = 0; i < nodes.length; ++i)
             nodes[i].neighbors.length = 0;
@@ -659,29 +699,70 @@ class HedgeMesh extends PolyMesh {
     }
 
     /**
-     * Perform a maximum matching on the dual graph
+     * Hand the dual graph's edges to the solver. Modules with the typed array
+     * bindings get them written straight into the solver's input buffer, older
+     * ones get a plain array of endpoint pairs
+     * @returns {Array|null} The array for the older bindings, or null
      */
-    getDualMatching() {
-        let res = this.getDualGraph();
-        let edges = new Array();
-        for (let e of res.edges) {
-            edges.push(e.p1.index);
-            edges.push(e.p2.index);
+    solverInput(edges) {
+        if (!solverHas("edgeInputView", "blossomView", "hamiltonianCycleView", "MatchingEngine")) {
+            let values = new Array();
+            for (let e of edges) {
+                values.push(e.p1.index);
+                values.push(e.p2.index);
+            }
+            return values;
         }
 
-        const matching = Module["blossom"](edges);
+        const input = Module["edgeInputView"](2 * edges.length);
+        for (let i = 0; i < edges.length; i++) {
+            input[2 * i] = edges[i].p1.index;
+            input[2 * i + 1] = edges[i].p2.index;
+        }
+        return null;
+    }
+
+    /**
+     * Copy a vector returned by the older bindings into a typed array and free it
+     */
+    solverOutput(vector) {
         try {
-            assert(matching.size() % 2 == 0, "Matching has an incomplete edge");
-            edges.length = 0;
-            for (let i = 0; i < matching.size(); i += 2) {
-                const v = matching.get(i);
-                const w = matching.get(i + 1);
-                edges.push(new Edge(res.nodes[v], res.nodes[w]));
+            let values = new Uint32Array(vector.size());
+            for (let i = 0; i < values.length; i++) {
+                values[i] = vector.get(i);
             }
-
+            return values;
         }
         finally {
-            matching.delete();
+            vector.delete();
+        }
+    }
+
+    /**
+     * Perform a maximum matching on the dual graph
+     */
+    getDualMatching() {
+        if (this.nativeDualInput("blossomFromTrianglesView")) {
+            const nodes = this.getDualNodes();
+            const matching = Module["blossomFromTrianglesView"](Module["MatchingEngine"].edmonds);
+            let edges = new Array();
+            for (let i = 0; i < matching.length; i += 2) {
+                edges.push(new Edge(nodes[matching[i]], nodes[matching[i + 1]]));
+            }
+
+            this.redoNeighbors(nodes, edges);
+            return {"nodes": nodes, "edges": edges};
+        }
+
+        let res = this.getDualGraph();
+        const values = this.solverInput(res.edges);
+        // the view is only valid until the next solver call, so it is read right away
+        const matching = values === null ? Module["blossomView"](Module["MatchingEngine"].edmonds)
+                                         : this.solverOutput(Module["blossom"](values));
+        assert(matching.length % 2 == 0, "Matching has an incomplete edge");
+        let edges = new Array();
+        for (let i = 0; i < matching.length; i += 2) {
+            edges.push(new Edge(res.nodes[matching[i]], res.nodes[matching[i + 1]]));
         }
 
         this.redoNeighbors(res.nodes, edges);
@@ -717,73 +798,203 @@ class HedgeMesh extends PolyMesh {
         return vec3.squaredDistance(p1, p2) < 0.001;
     }
 
-    getHamiltonianCycle() {
+    /**
+     * Find a Hamiltonian cycle on the dual graph, subdividing faces where the
+     * cycles of the cover have to be merged
+     * @param {Function} edgeWeight Optional, maps a dual Edge to a number; the
+     *        matching then has the least total weight, so heavy edges are kept
+     *        out of it where possible. Ignored by modules without weighted bindings
+     */
+    getHamiltonianCycle(edgeWeight) {
+        if (edgeWeight === undefined && this.nativeDualInput("hamiltonianCycleFromTrianglesView")) {
+            const cycleAndSubDivs = Module["hamiltonianCycleFromTrianglesView"](Module["MatchingEngine"].edmonds);
+            return this.cycleGraph({"nodes": this.getDualNodes()}, cycleAndSubDivs.graph, cycleAndSubDivs.subdivisions);
+        }
+
         let res = this.getDualGraph();
-        let edges = new Array();
-        for (let e of res.edges) {
-            edges.push(e.p1.index);
-            edges.push(e.p2.index);
+        const values = this.solverInput(res.edges);
+        let cycle, subdivisions;
+        if (values === null) {
+            let cycleAndSubDivs;
+            if (edgeWeight !== undefined && solverHas("weightInputView", "hamiltonianCycleWeightedView")) {
+                const weights = Module["weightInputView"](res.edges.length);
+                for (let i = 0; i < res.edges.length; i++) {
+                    weights[i] = edgeWeight(res.edges[i]);
+                }
+                cycleAndSubDivs = Module["hamiltonianCycleWeightedView"]();
+            }
+            else {
+                cycleAndSubDivs = Module["hamiltonianCycleView"](Module["MatchingEngine"].edmonds);
+            }
+
+            cycle = cycleAndSubDivs.graph;
+            subdivisions = cycleAndSubDivs.subdivisions;
+        }
+        else {
+            const cycleAndSubDivs = Module["hamiltonianCycle"](values);
+            cycle = this.solverOutput(cycleAndSubDivs.graph);
+            subdivisions = this.solverOutput(cycleAndSubDivs.subdivisions);
+        }
+
+        return this.cycleGraph(res, cycle, subdivisions);
+    }
+
+    /**
+     * getHamiltonianCycle() without blocking the page: the solver works in slices
+     * of a bounded number of augmentations and yields to the event loop between
+     * them, so an edit to the mesh can abort a solve that is no longer wanted
+     * @param {Object} options Optional: sliceSize augmentations per slice (256),
+     *        onProgress(matchedNodes, totalNodes) called after every slice, signal
+     *        an AbortSignal, timeoutMs a deadline for the whole solve
+     * @returns {Promise} The result of getHamiltonianCycle(), rejected with an
+     *          AbortError or TimeoutError DOMException when the solve stops early.
+     *          Modules without SolveTask solve in one blocking call
+     */
+    async getHamiltonianCycleAsync(options = {}) {
+        let res = this.getDualGraph();
+        if (!solverHas("SolveTask", "TaskStatus") || this.solverInput(res.edges) !== null) {
+            return this.getHamiltonianCycle();
         }
 
-        const cycleAndSubDivs = Module["hamiltonianCycle"](edges);
-        let cycle = cycleAndSubDivs.graph;
-        let subdivisions = cycleAndSubDivs.subdivisions;
+        const statuses = Module["TaskStatus"];
+        const task = new Module["SolveTask"](true, Module["MatchingEngine"].edmonds);
         try {
-            assert(cycle.size() % 2 == 0, "Cycle has an incomplete edge");
-            edges.length = 0;
-            for (let i = 0; i < cycle.size(); i += 2) {
-                const v = cycle.get(i);
-                const w = cycle.get(i + 1);
-                if (!res.nodes[v])
-                {
-                    res.nodes.length = Math.max(v + 1, res.nodes.length);
-                    res.nodes[v] = new Node(v, [0, 0, 0]);
+            if (options.timeoutMs !== undefined) {
+                task.setDeadline(options.timeoutMs);
+            }
+
+            let status = statuses.running;
+            while (status === statuses.running) {
+                if (options.signal !== undefined && options.signal.aborted) {
+                    task.cancel();
+                }
+
+                status = task.step(options.sliceSize === undefined ? 256 : options.sliceSize);
+                if (options.onProgress !== undefined) {
+                    options.onProgress(task.matchedNodes(), task.totalNodes());
                 }
 
-                if (!res.nodes[w])
-                {
-                    res.nodes.length = Math.max(w + 1, res.nodes.length);
-                    res.nodes[w] = new Node(w, [0, 0, 0]);
+                if (status === statuses.running) {
+                    await new Promise(resolve => setTimeout(resolve, 0));
                 }
+            }
 
-                edges.push(new Edge(res.nodes[v], res.nodes[w]));
+            if (status === statuses.cancelled) {
+                throw new DOMException("Solve cancelled", "AbortError");
             }
 
-            this.redoNeighbors(res.nodes, edges);
-            for (let i = 0; i < subdivisions.size(); i += 4) {
-                let orig1 = res.nodes[subdivisions.get(i)];
-                let sub1 = res.nodes[subdivisions.get(i + 1)];
-                let orig2 = res.nodes[subdivisions.get(i + 2)];
-                let sub2 = res.nodes[subdivisions.get(i + 3)];
-
-                this.shiftVertices(orig1, sub1, orig2, sub2);
-                this.shiftVertices(orig2, sub2, orig1, sub1);
-
-                if (this.segmentsCross(orig1.center, orig2.center, sub1.center, sub2.center)) {
-                    orig1.neighbors.splice(orig1.neighbors.indexOf(orig2), 1);
-                    orig2.neighbors.splice(orig2.neighbors.indexOf(orig1), 1);
-                    sub1.neighbors.splice(sub1.neighbors.indexOf(sub2), 1);
-                    sub2.neighbors.splice(sub2.neighbors.indexOf(sub1), 1);
-
-                    edges = edges.filter(e => !e.isEdge(orig1, orig2) && !e.isEdge(sub1, sub2));
-
-                    orig1.neighbors.push(sub2);
-                    orig2.neighbors.push(sub1);
-                    sub1.neighbors.push(orig2);
-                    sub2.neighbors.push(orig1);
-                    edges.push(new Edge(orig1, sub2));
-                    edges.push(new Edge(orig2, sub1));
-                }
+            if (status === statuses.expired) {
+                throw new DOMException("Solve deadline passed", "TimeoutError");
             }
+
+            const cycleAndSubDivs = task.hamiltonianCycleView();
+            return this.cycleGraph(res, cycleAndSubDivs.graph, cycleAndSubDivs.subdivisions);
         }
         finally {
-            cycle.delete();
-            subdivisions.delete();
+            task.delete();
+        }
+    }
+
+    /**
+     * Turn a cycle and its subdivisions as returned by the solver into dual graph
+     * nodes and edges, adding the twin nodes of subdivided faces
+     */
+    cycleGraph(res, cycle, subdivisions) {
+        assert(cycle.length % 2 == 0, "Cycle has an incomplete edge");
+        let edges = new Array();
+        for (let i = 0; i < cycle.length; i += 2) {
+            const v = cycle[i];
+            const w = cycle[i + 1];
+            if (!res.nodes[v])
+            {
+                res.nodes.length = Math.max(v + 1, res.nodes.length);
+                res.nodes[v] = new Node(v, [0, 0, 0]);
+            }
+
+            if (!res.nodes[w])
+            {
+                res.nodes.length = Math.max(w + 1, res.nodes.length);
+                res.nodes[w] = new Node(w, [0, 0, 0]);
+            }
+
+            edges.push(new Edge(res.nodes[v], res.nodes[w]));
+        }
+
+        this.redoNeighbors(res.nodes, edges);
+        for (let i = 0; i < subdivisions.length; i += 4) {
+            let orig1 = res.nodes[subdivisions[i]];
+            let sub1 = res.nodes[subdivisions[i + 1]];
+            let orig2 = res.nodes[subdivisions[i + 2]];
+            let sub2 = res.nodes[subdivisions[i + 3]];
+
+            this.shiftVertices(orig1, sub1, orig2, sub2);
+            this.shiftVertices(orig2, sub2, orig1, sub1);
+
+            if (this.segmentsCross(orig1.center, orig2.center, sub1.center, sub2.center)) {
+                orig1.neighbors.splice(orig1.neighbors.indexOf(orig2), 1);
+                orig2.neighbors.splice(orig2.neighbors.indexOf(orig1), 1);
+                sub1.neighbors.splice(sub1.neighbors.indexOf(sub2), 1);
+                sub2.neighbors.splice(sub2.neighbors.indexOf(sub1), 1);
+
+                edges = edges.filter(e => !e.isEdge(orig1, orig2) && !e.isEdge(sub1, sub2));
+
+                orig1.neighbors.push(sub2);
+                orig2.neighbors.push(sub1);
+                sub1.neighbors.push(orig2);
+                sub2.neighbors.push(orig1);
+                edges.push(new Edge(orig1, sub2));
+                edges.push(new Edge(orig2, sub1));
+            }
         }
  
         return {"nodes": res.nodes, "edges": edges};
     }
 
+    /**
+     * Order the faces along the dual Hamiltonian cycle and emit them as a single
+     * triangle strip. Faces that were split to merge cycles share a new vertex in
+     * the middle of their common edge, numbered after the existing vertices.
+     * Expects a triangle mesh, so that face i is triangle i of getTriangleIndices
+     * @returns {'indices': Uint32Array strip, 'midpoints': Uint32Array with the
+     *           two endpoints of the edge each new vertex splits}, or null if the
+     *           module predates the typed array bindings
+     */
+    getTriangleStrip() {
+        if (this.nativeDualInput("triangleStripFromTrianglesView")) {
+            const strip = Module["triangleStripFromTrianglesView"](Module["MatchingEngine"].edmonds);
+            return {"indices": strip.indices.slice(), "midpoints": strip.midpoints.slice()};
+        }
+
+        if (!solverHas("triangleInputView", "triangleStripView")) {
+            return null;
+        }
+
+        let res = this.getDualGraph();
+        if (this.solverInput(res.edges) !== null) {
+            return null;
+        }
+
+        const triangles = this.getTriangleIndices();
+        Module["triangleInputView"](triangles.length).set(triangles);
+        const strip = Module["triangleStripView"](Module["MatchingEngine"].edmonds);
+        // copies, the views die with the next solver call
+        return {"indices": strip.indices.slice(), "midpoints": strip.midpoints.slice()};
+    }
+
+    /**
+     * Counters and per-phase timings of the last solver call, see solve_stats in
+     * blossom.h. Call setTracing(true) on the module beforehand to also record the
+     * phases as Chrome trace events, read back with traceJson()
+     * @returns {Object|null} The stats, or null if the module predates them
+     */
+    getSolveStats() {
+        if (!solverHas("lastSolveStats")) {
+            return null;
+        }
+
+        return Module["lastSolveStats"]();
+    }
+
 }
 
 class Node {
@@ -0,0 +1,114 @@
+#ifndef ADJACENCY_GRAPH_H
+#define ADJACENCY_GRAPH_H
+
+#include "csr_graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <utility>
+#include <vector>
+
+// mutable adjacency lists indexed by dense node id, for graphs that are edited
+// in place; rows are unsorted and mesh duals keep them at three entries or so
+template<typename T = std::uint32_t>
+class adjacency_graph
+{
+    std::vector<std::vector<T>> rows;
+    std::size_t edgeCount;
+
+    public:
+        using node_type = T;
+
+        adjacency_graph(): rows(), edgeCount(0) {}
+
+        explicit adjacency_graph(const csr_graph<T>& other): rows(other.num_nodes()), edgeCount(other.num_edges())
+        {
+            for (std::size_t v = 0; v < rows.size(); ++v)
+            {
+                auto row = other.edges_of_node(static_cast<T>(v));
+                rows[v].assign(row.begin(), row.end());
+            }
+        }
+
+        // one past the largest node id, matching csr_graph
+        std::size_t num_nodes() const
+        {
+            return rows.size();
+        }
+
+        std::size_t num_edges() const
+        {
+            return edgeCount;
+        }
+
+        std::size_t degree(T v) const
+        {
+            return v < rows.size() ? rows[v].size() : 0;
+        }
+
+        bool has_node(T v) const
+        {
+            return degree(v) != 0;
+        }
+
+        bool has_edge(T v1, T v2) const
+        {
+            auto row = edges_of_node(v1);
+            return std::find(row.begin(), row.end(), v2) != row.end();
+        }
+
+        std::span<const T> edges_of_node(T v) const
+        {
+            if (v >= rows.size())
+            {
+                return {};
+            }
+
+            return rows[v];
+        }
+
+        void resize(std::size_t n)
+        {
+            if (n > rows.size())
+            {
+                rows.resize(n);
+            }
+        }
+
+        bool add_edge(T v1, T v2)
+        {
+            if (v1 == v2 || has_edge(v1, v2))
+            {
+                return false;
+            }
+
+            resize(static_cast<std::size_t>(std::max(v1, v2)) + 1);
+            rows[v1].push_back(v2);
+            rows[v2].push_back(v1);
+            ++edgeCount;
+            return true;
+        }
+
+        bool remove_edge(T v1, T v2)
+        {
+            if (!has_edge(v1, v2))
+            {
+                return false;
+            }
+
+            for (auto [a, b] : {std::pair{v1, v2}, std::pair{v2, v1}})
+            {
+                auto& row = rows[a];
+                *std::find(row.begin(), row.end(), b) = row.back();
+                row.pop_back();
+            }
+
+            --edgeCount;
+            return true;
+        }
+};
+
+#endif
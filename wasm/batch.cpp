@@ -0,0 +1,240 @@
+#include "blossom.h"
+#include "cache.h"
+#include "mesh_io.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+void usage(const char* argv0)
+{
+    std::cerr << "usage: " << argv0 << " [--engine contraction|edmonds|phased|parallel] [-o OUTDIR] [--trace FILE]"
+        << " [--cache DIR] [--patch-nodes N] [--threads N] INPUT...\n"
+        << "  INPUT is an .obj/.off/.ply mesh or a directory of them. For every mesh the\n"
+        << "  Hamiltonian cycle on its face dual is written to <file>.cycle, next to the\n"
+        << "  input unless OUTDIR is given. --trace writes the solver phases of all meshes\n"
+        << "  as a Chrome trace event file. --cache keeps results in DIR keyed by the\n"
+        << "  dual graph's edges, meshes solved before are read back instead of solved.\n"
+        << "  --patch-nodes solves in patches of N consecutive faces, for meshes too\n"
+        << "  large to solve whole. --threads sets the worker threads of the parallel\n"
+        << "  engine and of patch solves, one per core by default.\n";
+}
+
+void writeCycle(const std::filesystem::path& path, const std::filesystem::path& source, std::size_t numFaces,
+        const std::vector<node_t>& cycle, const std::vector<node_t>& subdivisions)
+{
+    std::ofstream out(path);
+    if (!out)
+    {
+        throw std::runtime_error(path.string() + ": cannot open for writing");
+    }
+
+    // nodes below `faces` are triangles of the input, the twins of subdivisions are
+    // numbered from `faces` on
+    out << "# hamiltonian cycle on the face dual of " << source.filename().string() << "\n";
+    out << "faces " << numFaces << "\n";
+    out << "cycle " << cycle.size() / 2 << "\n";
+    for (std::size_t i = 0; i + 1 < cycle.size(); i += 2)
+    {
+        out << cycle[i] << " " << cycle[i + 1] << "\n";
+    }
+
+    // each entry is: original node, its new twin, matched neighbor, that neighbor's twin
+    out << "subdivisions " << subdivisions.size() / 4 << "\n";
+    for (std::size_t i = 0; i + 3 < subdivisions.size(); i += 4)
+    {
+        out << subdivisions[i] << " " << subdivisions[i + 1] << " "
+            << subdivisions[i + 2] << " " << subdivisions[i + 3] << "\n";
+    }
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    matching_engine engine = matching_engine::edmonds;
+    std::filesystem::path outDir;
+    std::filesystem::path tracePath;
+    std::filesystem::path cacheDir;
+    std::optional<partition_options> partitioning;
+    std::vector<std::filesystem::path> inputs;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if ((arg == "--engine" || arg == "-o" || arg == "--trace" || arg == "--cache" || arg == "--patch-nodes"
+            || arg == "--threads") && i + 1 == argc)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+
+        if (arg == "--engine")
+        {
+            std::string name = argv[++i];
+            if (name == "contraction")
+            {
+                engine = matching_engine::contraction;
+            }
+            else if (name == "edmonds")
+            {
+                engine = matching_engine::edmonds;
+            }
+            else if (name == "phased")
+            {
+                engine = matching_engine::phased;
+            }
+            else if (name == "parallel")
+            {
+                engine = matching_engine::parallel;
+            }
+            else
+            {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else if (arg == "-o")
+        {
+            outDir = argv[++i];
+        }
+        else if (arg == "--trace")
+        {
+            tracePath = argv[++i];
+        }
+        else if (arg == "--cache")
+        {
+            cacheDir = argv[++i];
+        }
+        else if (arg == "--patch-nodes")
+        {
+            partitioning.emplace();
+            partitioning->patchNodes = std::strtoull(argv[++i], nullptr, 10);
+            if (partitioning->patchNodes == 0)
+            {
+                usage(argv[0]);
+                return 2;
+            }
+        }
+        else if (arg == "--threads")
+        {
+            setSolverThreads(std::strtoull(argv[++i], nullptr, 10));
+        }
+        else if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else
+        {
+            inputs.emplace_back(arg);
+        }
+    }
+
+    if (inputs.empty())
+    {
+        usage(argv[0]);
+        return 2;
+    }
+
+    std::vector<std::filesystem::path> meshes;
+    for (const auto& input : inputs)
+    {
+        if (std::filesystem::is_directory(input))
+        {
+            std::vector<std::filesystem::path> found;
+            for (const auto& entry : std::filesystem::directory_iterator(input))
+            {
+                if (entry.is_regular_file() && isMeshFile(entry.path()))
+                {
+                    found.push_back(entry.path());
+                }
+            }
+
+            std::sort(found.begin(), found.end());
+            meshes.insert(meshes.end(), found.begin(), found.end());
+        }
+        else
+        {
+            meshes.push_back(input);
+        }
+    }
+
+    if (!outDir.empty())
+    {
+        std::filesystem::create_directories(outDir);
+    }
+
+    std::optional<result_cache> cache;
+    if (!cacheDir.empty())
+    {
+        cache.emplace(cacheDir);
+        if (partitioning)
+        {
+            cache->solve_in_patches(*partitioning);
+        }
+    }
+
+    setTracing(!tracePath.empty());
+    int failures = 0;
+    for (const auto& meshPath : meshes)
+    {
+        try
+        {
+            auto start = std::chrono::steady_clock::now();
+            triangle_mesh mesh = readMesh(meshPath);
+            auto edges = dualGraphEdges(mesh.triangles);
+            std::size_t hits = cache ? cache->hits() : 0;
+            auto [cycle, subdivisions] = cache ? cache->hamiltonianCycle(edges, engine)
+                : partitioning ? hamiltonianCyclePartitioned(edges, *partitioning, engine)
+                : hamiltonianCycle(edges, engine);
+            bool cached = cache && cache->hits() != hits;
+            numberTwinsFrom(mesh.num_faces(), cycle, subdivisions);
+
+            auto outPath = (outDir.empty() ? meshPath.parent_path() : outDir) / meshPath.filename();
+            outPath += ".cycle";
+            writeCycle(outPath, meshPath, mesh.num_faces(), cycle, subdivisions);
+
+            std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+            std::cout << meshPath.string() << ": " << mesh.num_faces() << " faces, "
+                << subdivisions.size() / 4 << " subdivisions, " << elapsed.count() << " ms";
+            if (cached)
+            {
+                std::cout << " (cached)\n";
+                continue;
+            }
+
+            const solve_stats& stats = lastSolveStats();
+            std::cout << " (" << stats.totalMilliseconds << " ms solving, " << stats.augmentations << " augmentations, "
+                << stats.contractions << " blossoms)\n";
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << e.what() << "\n";
+            ++failures;
+        }
+    }
+
+    if (!tracePath.empty())
+    {
+        std::ofstream out(tracePath);
+        out << traceJson();
+        if (!out)
+        {
+            std::cerr << tracePath.string() << ": cannot write trace\n";
+            ++failures;
+        }
+    }
+
+    return failures == 0 ? 0 : 1;
+}
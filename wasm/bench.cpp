@@ -0,0 +1,241 @@
+#include "blossom.h"
+#include "generators.h"
+#include "mesh_io.h"
+#include "stats.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// heap accounting for peak memory per case, every allocation carries its size in a header
+namespace
+{
+
+constexpr std::size_t headerSize = alignof(std::max_align_t);
+std::atomic<std::size_t> liveBytes{0};
+std::atomic<std::size_t> peakBytes{0};
+
+}
+
+void* operator new(std::size_t size)
+{
+    auto* block = static_cast<char*>(std::malloc(size + headerSize));
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    *reinterpret_cast<std::size_t*>(block) = size;
+    countAllocation(size);
+    std::size_t live = liveBytes += size;
+    std::size_t peak = peakBytes.load();
+    while (live > peak && !peakBytes.compare_exchange_weak(peak, live))
+    {
+    }
+
+    return block + headerSize;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr != nullptr)
+    {
+        char* block = static_cast<char*>(ptr) - headerSize;
+        liveBytes -= *reinterpret_cast<std::size_t*>(block);
+        std::free(block);
+    }
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+namespace
+{
+
+struct bench_case
+{
+    std::string name;
+    std::vector<std::uint32_t> triangles;
+};
+
+const char* engineName(matching_engine engine)
+{
+    switch (engine)
+    {
+        case matching_engine::contraction: return "contraction";
+        case matching_engine::edmonds: return "edmonds";
+        case matching_engine::phased: return "phased";
+        case matching_engine::parallel: return "parallel";
+    }
+
+    return "unknown";
+}
+
+std::vector<bench_case> makeCases(std::size_t faces, std::uint32_t seed)
+{
+    std::vector<bench_case> cases;
+    auto level = static_cast<unsigned>(std::lround(std::log(static_cast<double>(faces) / 20) / std::log(4.0)));
+    cases.push_back({"icosphere", icosphere(level)});
+
+    auto segments = std::max<std::size_t>(3, static_cast<std::size_t>(std::sqrt(static_cast<double>(faces) / 2)));
+    cases.push_back({"torus", torus(std::max<std::size_t>(3, faces / (2 * segments)), segments)});
+
+    cases.push_back({"random", randomTriangulation(faces, seed)});
+
+    std::size_t length = std::max<std::size_t>(3, faces / 54);
+    cases.push_back({"strip", longStrip(length)});
+    return cases;
+}
+
+// one JSON object per line so results can be diffed and loaded without a parser of our own
+void runCase(const bench_case& c, const std::vector<node_t>& dual, matching_engine engine, const char* stage,
+        const char* resultName, const std::function<std::size_t()>& solve, int repeat)
+{
+    double bestMs = 0;
+    std::size_t peak = 0;
+    std::size_t result = 0;
+    for (int i = 0; i < repeat; ++i)
+    {
+        std::size_t baseline = liveBytes.load();
+        peakBytes = baseline;
+        auto start = std::chrono::steady_clock::now();
+        result = solve();
+        std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+        bestMs = i == 0 ? elapsed.count() : std::min(bestMs, elapsed.count());
+        peak = std::max(peak, peakBytes.load() - baseline);
+    }
+
+    const solve_stats& stats = lastSolveStats();
+    std::cout << "{\"mesh\":\"" << c.name << "\",\"faces\":" << c.triangles.size() / 3
+        << ",\"dual_edges\":" << dual.size() / 2
+        << ",\"engine\":\"" << engineName(engine) << "\",\"stage\":\"" << stage
+        << "\",\"ms\":" << bestMs
+        << ",\"greedy_matches\":" << stats.greedyMatches
+        << ",\"augmentations\":" << stats.augmentations
+        << ",\"contractions\":" << stats.contractions
+        << ",\"pendant_matches\":" << stats.pendantMatches
+        << ",\"folds\":" << stats.folds
+        << ",\"kernel_nodes\":" << stats.kernelNodes
+        << ",\"max_blossom_depth\":" << stats.maxBlossomDepth
+        << ",\"search_queue_peak\":" << stats.searchQueuePeak
+        << ",\"cycle_queue_peak\":" << stats.cycleQueuePeak
+        << ",\"allocations\":" << stats.allocations
+        << ",\"allocated_bytes\":" << stats.allocatedBytes
+        << ",\"cubic\":" << (stats.cubic ? "true" : "false")
+        << ",\"node_bytes\":" << stats.nodeBytes
+        << ",\"" << resultName << "\":" << result
+        << ",\"peak_bytes\":" << peak << ",\"phases\":{";
+    for (std::size_t i = 0; i < stats.phases.size(); ++i)
+    {
+        std::cout << (i == 0 ? "\"" : ",\"") << stats.phases[i].name << "\":{\"calls\":" << stats.phases[i].calls
+            << ",\"ms\":" << stats.phases[i].milliseconds << "}";
+    }
+
+    std::cout << "}}" << std::endl;
+}
+
+void usage(const char* argv0)
+{
+    std::cerr << "usage: " << argv0 << " [--max-faces N] [--contraction-limit N] [--repeat N] [--seed S]"
+        << " [--trace FILE]\n"
+        << "  Solves synthetic dual graphs at 1k, 10k, 100k and 1M faces (up to --max-faces) with every\n"
+        << "  engine and prints one JSON object per case. The contraction engine is skipped above\n"
+        << "  --contraction-limit faces (default 5000). --trace writes every solver phase as a Chrome\n"
+        << "  trace event file.\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::size_t maxFaces = 1000000;
+    std::size_t contractionLimit = 5000;
+    int repeat = 1;
+    std::uint32_t seed = 1;
+    std::string tracePath;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if (arg == "-h" || arg == "--help")
+        {
+            usage(argv[0]);
+            return 0;
+        }
+        else if (i + 1 == argc)
+        {
+            usage(argv[0]);
+            return 2;
+        }
+        else if (arg == "--max-faces")
+        {
+            maxFaces = std::stoull(argv[++i]);
+        }
+        else if (arg == "--contraction-limit")
+        {
+            contractionLimit = std::stoull(argv[++i]);
+        }
+        else if (arg == "--repeat")
+        {
+            repeat = std::max(1, std::stoi(argv[++i]));
+        }
+        else if (arg == "--seed")
+        {
+            seed = static_cast<std::uint32_t>(std::stoul(argv[++i]));
+        }
+        else if (arg == "--trace")
+        {
+            tracePath = argv[++i];
+        }
+        else
+        {
+            usage(argv[0]);
+            return 2;
+        }
+    }
+
+    setTracing(!tracePath.empty());
+    for (std::size_t faces = 1000; faces <= maxFaces; faces *= 10)
+    {
+        for (const auto& c : makeCases(faces, seed))
+        {
+            auto dual = dualGraphEdges(c.triangles);
+            for (auto engine : {matching_engine::contraction, matching_engine::edmonds, matching_engine::phased,
+                matching_engine::parallel})
+            {
+                if (engine == matching_engine::contraction && c.triangles.size() / 3 > contractionLimit)
+                {
+                    continue;
+                }
+
+                runCase(c, dual, engine, "blossom", "matched",
+                    [&]() { return blossom(dual, engine).size() / 2; }, repeat);
+                runCase(c, dual, engine, "hamiltonianCycle", "subdivisions",
+                    [&]() { return hamiltonianCycle(dual, engine).second.size() / 4; }, repeat);
+            }
+        }
+    }
+
+    if (!tracePath.empty())
+    {
+        std::ofstream out(tracePath);
+        out << traceJson();
+        if (!out)
+        {
+            std::cerr << tracePath << ": cannot write trace\n";
+            return 1;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,335 @@
+// JS bindings of the solver, the only part of the wasm module not shared with the
+// native library
+#include "blossom.h"
+#include "session.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <emscripten/bind.h>
+#include <emscripten/val.h>
+
+int main()
+{
+    return 0;
+}
+
+using hCycleRetType = std::pair<std::vector<node_t>, std::vector<node_t>>;
+using session_t = matching_session<node_t>;
+
+// solver-owned buffers behind the typed array entry points: JS writes edges straight
+// into the input view and reads results from views over the outputs, so nothing is
+// converted element by element; every view is invalidated by the next call that
+// writes the same buffer and by heap growth, so read results before solving again
+std::vector<node_t> inputBuffer;
+std::vector<double> weightBuffer;
+std::vector<node_t> triangleBuffer;
+std::vector<node_t> outputBuffer;
+std::vector<node_t> subdivisionBuffer;
+
+emscripten::val heapView(const std::vector<node_t>& values)
+{
+    return emscripten::val(emscripten::typed_memory_view(values.size(), values.data()));
+}
+
+// weights are doubles on the JS side and rounded to integers here, scale them up
+// first where fractions matter
+std::vector<std::int64_t> roundedWeights(std::span<const double> weights)
+{
+    std::vector<std::int64_t> ret(weights.size());
+    std::transform(weights.begin(), weights.end(), ret.begin(), [](double w) { return std::llround(w); });
+    return ret;
+}
+
+std::vector<node_t> blossomValues(const emscripten::val& edgeData, matching_engine engine)
+{
+    return blossom(emscripten::convertJSArrayToNumberVector<node_t>(edgeData), engine);
+}
+
+hCycleRetType hamiltonianCycleValues(const emscripten::val& edgeData, matching_engine engine)
+{
+    return hamiltonianCycle(emscripten::convertJSArrayToNumberVector<node_t>(edgeData), engine);
+}
+
+emscripten::val edgeInputView(std::size_t count)
+{
+    inputBuffer.resize(count);
+    return heapView(inputBuffer);
+}
+
+// one weight per edge of the input view, read by the weighted entry points
+emscripten::val weightInputView(std::size_t count)
+{
+    weightBuffer.resize(count);
+    return emscripten::val(emscripten::typed_memory_view(weightBuffer.size(), weightBuffer.data()));
+}
+
+// face index buffer for triangleStripView(), 3 vertex indices per dual node
+emscripten::val triangleInputView(std::size_t count)
+{
+    triangleBuffer.resize(count);
+    return heapView(triangleBuffer);
+}
+
+emscripten::val blossomView(matching_engine engine)
+{
+    outputBuffer = blossom(inputBuffer, engine);
+    return heapView(outputBuffer);
+}
+
+emscripten::val hamiltonianCycleView(matching_engine engine)
+{
+    std::tie(outputBuffer, subdivisionBuffer) = hamiltonianCycle(inputBuffer, engine);
+    emscripten::val ret = emscripten::val::object();
+    ret.set("graph", heapView(outputBuffer));
+    ret.set("subdivisions", heapView(subdivisionBuffer));
+    return ret;
+}
+
+emscripten::val blossomWeightedView()
+{
+    outputBuffer = blossomWeighted(inputBuffer, roundedWeights(weightBuffer));
+    return heapView(outputBuffer);
+}
+
+emscripten::val hamiltonianCycleWeightedView()
+{
+    std::tie(outputBuffer, subdivisionBuffer) = hamiltonianCycleWeighted(inputBuffer, roundedWeights(weightBuffer));
+    emscripten::val ret = emscripten::val::object();
+    ret.set("graph", heapView(outputBuffer));
+    ret.set("subdivisions", heapView(subdivisionBuffer));
+    return ret;
+}
+
+// inputs too large to solve as one graph, in patches of patchNodes consecutive ids
+emscripten::val blossomPartitionedView(std::size_t patchNodes)
+{
+    partition_options options;
+    options.patchNodes = patchNodes;
+    outputBuffer = blossomPartitioned(inputBuffer, options);
+    return heapView(outputBuffer);
+}
+
+emscripten::val hamiltonianCyclePartitionedView(std::size_t patchNodes)
+{
+    partition_options options;
+    options.patchNodes = patchNodes;
+    std::tie(outputBuffer, subdivisionBuffer) = hamiltonianCyclePartitioned(inputBuffer, options);
+    emscripten::val ret = emscripten::val::object();
+    ret.set("graph", heapView(outputBuffer));
+    ret.set("subdivisions", heapView(subdivisionBuffer));
+    return ret;
+}
+
+emscripten::val hamiltonianOrderView(matching_engine engine)
+{
+    auto result = hamiltonianOrder(inputBuffer, engine);
+    outputBuffer = std::move(result.order);
+    subdivisionBuffer = std::move(result.subdivisions);
+    emscripten::val ret = emscripten::val::object();
+    ret.set("order", heapView(outputBuffer));
+    ret.set("subdivisions", heapView(subdivisionBuffer));
+    return ret;
+}
+
+emscripten::val triangleStripView(matching_engine engine)
+{
+    auto result = triangleStrip(triangleBuffer, inputBuffer, engine);
+    outputBuffer = std::move(result.indices);
+    subdivisionBuffer = std::move(result.midpoints);
+    emscripten::val ret = emscripten::val::object();
+    ret.set("indices", heapView(outputBuffer));
+    ret.set("midpoints", heapView(subdivisionBuffer));
+    return ret;
+}
+
+// entry points on the face index buffer of triangleInputView(), the dual graph is
+// built in the module
+emscripten::val dualGraphView()
+{
+    outputBuffer = dualGraph(triangleBuffer);
+    return heapView(outputBuffer);
+}
+
+emscripten::val blossomFromTrianglesView(matching_engine engine)
+{
+    outputBuffer = blossomFromTriangles(triangleBuffer, engine);
+    return heapView(outputBuffer);
+}
+
+emscripten::val hamiltonianCycleFromTrianglesView(matching_engine engine)
+{
+    std::tie(outputBuffer, subdivisionBuffer) = hamiltonianCycleFromTriangles(triangleBuffer, engine);
+    emscripten::val ret = emscripten::val::object();
+    ret.set("graph", heapView(outputBuffer));
+    ret.set("subdivisions", heapView(subdivisionBuffer));
+    return ret;
+}
+
+emscripten::val triangleStripFromTrianglesView(matching_engine engine)
+{
+    auto result = triangleStripFromTriangles(triangleBuffer, engine);
+    outputBuffer = std::move(result.indices);
+    subdivisionBuffer = std::move(result.midpoints);
+    emscripten::val ret = emscripten::val::object();
+    ret.set("indices", heapView(outputBuffer));
+    ret.set("midpoints", heapView(subdivisionBuffer));
+    return ret;
+}
+
+session_t* makeSession(const emscripten::val& edgeData)
+{
+    auto edgeNums = emscripten::convertJSArrayToNumberVector<node_t>(edgeData);
+    return new session_t(std::span<const node_t>(edgeNums));
+}
+
+std::size_t updateSession(session_t& session, const emscripten::val& addedEdges, const emscripten::val& removedEdges,
+        const emscripten::val& removedNodes)
+{
+    auto added = emscripten::convertJSArrayToNumberVector<node_t>(addedEdges);
+    auto removed = emscripten::convertJSArrayToNumberVector<node_t>(removedEdges);
+    auto nodes = emscripten::convertJSArrayToNumberVector<node_t>(removedNodes);
+    return session.update(added, removed, nodes);
+}
+
+// a task solves the edges in the input view at the time it is made, so JS can fill
+// the view for the next solve while an obsolete one is being cancelled
+solve_task* makeTask(bool hamiltonian, matching_engine engine)
+{
+    return new solve_task(inputBuffer, hamiltonian, engine);
+}
+
+void setTaskDeadline(solve_task& task, double milliseconds)
+{
+    auto delay = std::chrono::duration<double, std::milli>(milliseconds);
+    task.set_deadline(std::chrono::steady_clock::now()
+        + std::chrono::duration_cast<std::chrono::steady_clock::duration>(delay));
+}
+
+// views over the task's own results, valid until the task is deleted
+emscripten::val taskMatchingView(const solve_task& task)
+{
+    return heapView(task.matching());
+}
+
+emscripten::val taskCycleView(const solve_task& task)
+{
+    emscripten::val ret = emscripten::val::object();
+    ret.set("graph", heapView(task.cycle()));
+    ret.set("subdivisions", heapView(task.subdivisions()));
+    return ret;
+}
+
+// a plain object rather than a bound struct, so JS has nothing to delete(); phases
+// are keyed by name
+emscripten::val solveStatsObject()
+{
+    const solve_stats& stats = lastSolveStats();
+    emscripten::val phases = emscripten::val::object();
+    for (const auto& phase : stats.phases)
+    {
+        emscripten::val entry = emscripten::val::object();
+        entry.set("calls", phase.calls);
+        entry.set("ms", phase.milliseconds);
+        phases.set(phase.name, entry);
+    }
+
+    emscripten::val ret = emscripten::val::object();
+    ret.set("greedyMatches", stats.greedyMatches);
+    ret.set("augmentations", stats.augmentations);
+    ret.set("contractions", stats.contractions);
+    ret.set("pendantMatches", stats.pendantMatches);
+    ret.set("folds", stats.folds);
+    ret.set("kernelNodes", stats.kernelNodes);
+    ret.set("maxBlossomDepth", stats.maxBlossomDepth);
+    ret.set("searchQueuePeak", stats.searchQueuePeak);
+    ret.set("cycleQueuePeak", stats.cycleQueuePeak);
+    ret.set("allocations", stats.allocations);
+    ret.set("allocatedBytes", stats.allocatedBytes);
+    ret.set("ms", stats.totalMilliseconds);
+    ret.set("cubic", stats.cubic);
+    ret.set("nodeBytes", stats.nodeBytes);
+    ret.set("patches", stats.patches);
+    ret.set("boundaryNodes", stats.boundaryNodes);
+    ret.set("phases", phases);
+    return ret;
+}
+
+EMSCRIPTEN_BINDINGS(module)
+{
+    emscripten::enum_<matching_engine>("MatchingEngine")
+        .value("contraction", matching_engine::contraction)
+        .value("edmonds", matching_engine::edmonds)
+        .value("phased", matching_engine::phased)
+        .value("parallel", matching_engine::parallel)
+    ;
+
+    emscripten::enum_<task_status>("TaskStatus")
+        .value("running", task_status::running)
+        .value("done", task_status::done)
+        .value("cancelled", task_status::cancelled)
+        .value("expired", task_status::expired)
+    ;
+
+    emscripten::function("blossom", emscripten::optional_override(
+        [](const emscripten::val& edgeData) { return blossomValues(edgeData, matching_engine::edmonds); }));
+    emscripten::function("blossomWithEngine", &blossomValues);
+    emscripten::function("hamiltonianCycle", emscripten::optional_override(
+        [](const emscripten::val& edgeData) { return hamiltonianCycleValues(edgeData, matching_engine::edmonds); }));
+    emscripten::function("hamiltonianCycleWithEngine", &hamiltonianCycleValues);
+    emscripten::function("edgeInputView", &edgeInputView);
+    emscripten::function("blossomView", &blossomView);
+    emscripten::function("hamiltonianCycleView", &hamiltonianCycleView);
+    emscripten::function("weightInputView", &weightInputView);
+    emscripten::function("blossomWeightedView", &blossomWeightedView);
+    emscripten::function("hamiltonianCycleWeightedView", &hamiltonianCycleWeightedView);
+    emscripten::function("blossomPartitionedView", &blossomPartitionedView);
+    emscripten::function("hamiltonianCyclePartitionedView", &hamiltonianCyclePartitionedView);
+    emscripten::function("triangleInputView", &triangleInputView);
+    emscripten::function("hamiltonianOrderView", &hamiltonianOrderView);
+    emscripten::function("triangleStripView", &triangleStripView);
+    emscripten::function("dualGraphView", &dualGraphView);
+    emscripten::function("blossomFromTrianglesView", &blossomFromTrianglesView);
+    emscripten::function("hamiltonianCycleFromTrianglesView", &hamiltonianCycleFromTrianglesView);
+    emscripten::function("triangleStripFromTrianglesView", &triangleStripFromTrianglesView);
+    emscripten::function("lastSolveStats", &solveStatsObject);
+    emscripten::function("setTracing", &setTracing);
+    emscripten::function("setSolverThreads", &setSolverThreads);
+    emscripten::function("traceJson", &traceJson);
+    
+    emscripten::value_object<hCycleRetType>("pair<vector<node_t>,vector<node_t>>")
+        .field("graph", &hCycleRetType::first)
+        .field("subdivisions", &hCycleRetType::second)
+    ;
+    
+    emscripten::register_vector<node_t>("vector<node_t>");
+
+    // stateful variant for interactive editing, JS owns the object and must delete() it
+    emscripten::class_<session_t>("MatchingSession")
+        .constructor(&makeSession, emscripten::allow_raw_pointers())
+        .function("update", &updateSession)
+        .function("size", &session_t::size)
+        .function("matching", &session_t::matching)
+        .function("hamiltonianCycle", &session_t::hamiltonian_cycle)
+    ;
+
+    // sliced solve of the input view, JS owns the object and must delete() it
+    emscripten::class_<solve_task>("SolveTask")
+        .constructor(&makeTask, emscripten::allow_raw_pointers())
+        .function("step", &solve_task::step)
+        .function("cancel", &solve_task::cancel)
+        .function("setDeadline", &setTaskDeadline)
+        .function("status", &solve_task::status)
+        .function("matchedNodes", &solve_task::matched_nodes)
+        .function("totalNodes", &solve_task::total_nodes)
+        .function("matchingView", &taskMatchingView)
+        .function("hamiltonianCycleView", &taskCycleView)
+    ;
+}
@@ -1,5 +1,22 @@
+#include "blossom.h"
+#include "csr_graph.h"
+#include "cubic.h"
+#include "dual.h"
+#include "edmonds.h"
 #include "graph.h"
+#include "greedy.h"
 #include "forest.h"
+#include "kernel.h"
+#include "stats.h"
+#include "strip.h"
+#include "weighted.h"
+
+#ifdef BLOSSOM_THREADS
+#include "parallel.h"
+
+#include <atomic>
+#include <thread>
+#endif
 
 #include <algorithm>
 #include <cassert>
@@ -8,194 +25,183 @@
 #include <iostream>
 #include <iterator>
 #include <limits>
+#include <memory>
+#include <numeric>
 #include <optional>
+#include <span>
+#include <tuple>
 #include <unordered_map>
-#include <unordered_set>
 #include <utility>
 #include <vector>
 
-#ifdef __EMSCRIPTEN__
+using graph_t = graph<node_t>;
+using csr_t = csr_graph<node_t>;
+using forest_t = forest<node_t>;
+
+constexpr node_t unmatched = edmonds<csr_t>::npos;
 
-#include <emscripten/bind.h>
-#include <emscripten/val.h>
+// see setSolverThreads(), 0 for one per core
+thread_local std::size_t solverThreadCount = 0;
 
-int main()
+void setSolverThreads(std::size_t threads)
 {
-    return 0;
+    solverThreadCount = threads;
 }
 
+#ifdef BLOSSOM_THREADS
+std::size_t solverThreads()
+{
+    return solverThreadCount != 0 ? solverThreadCount : std::max(1u, std::thread::hardware_concurrency());
+}
 #endif
 
-using node_t = std::uint32_t;
-using graph_t = graph<node_t>;
-using forest_t = forest<node_t>;
+// scratch space of a legacy search, one per contraction level so that the search on
+// a contracted graph leaves its caller's intact; reset for every search, never freed
+struct search_level
+{
+    forest_t trees;
+    std::vector<node_t> queue;
+    std::vector<std::uint8_t> scanned;
+    // the blossom being contracted as an odd cycle starting at its base, and the
+    // position of every vertex in it, unmatched for vertices outside
+    std::vector<node_t> cycle;
+    std::vector<node_t> blossomIndex;
+    std::vector<node_t> contractedMates;
+};
 
-graph_t contracted(const graph_t& graph, const graph_t& blossom, node_t contractNode)
+class search_arena
 {
-    graph_t ret = graph;
-    auto nodesPair = blossom.nodes();
-    std::unordered_set<node_t> needConnection;
-    for (auto i = nodesPair.first; i != nodesPair.second; ++i)
-    {
-        node_t v2 = *i;
-        for (const auto& otherV : ret.edges_of_node(v2))
+    // a deque, so levels stay put while deeper ones are added
+    std::deque<search_level> levels;
+
+    public:
+        search_level& level(std::size_t depth)
         {
-            if (!blossom.has_node(otherV))
+            if (depth == levels.size())
             {
-                needConnection.insert(otherV);
+                levels.emplace_back();
             }
-        }
-
-        ret.remove_node(v2);
-    }
-
-    for (const auto& otherV : needConnection)
-    {
-        ret.add_edge(contractNode, otherV);
-    }
 
-    return ret;
-}
+            return levels[depth];
+        }
+};
 
-std::vector<node_t> findAlternatingPath(const graph_t& matching, const graph_t& blossom, const std::vector<std::pair<node_t, node_t>>& pathEnds)
+// the blossom is replaced by contractNode, keeping one edge to each outside neighbor
+template<typename Graph>
+graph_t contracted(const Graph& graph, const std::vector<node_t>& blossomIndex, node_t contractNode)
 {
-    std::optional<node_t> v = std::nullopt;
-    std::optional<node_t> w = std::nullopt;
-    if (pathEnds.size() == 1)
+    phase_timer timer("contract");
+    graph_t ret;
+    for (const auto& [v1, v2] : graph.edges())
     {
-        w.emplace(pathEnds[0].second);
-        auto nodePair = blossom.nodes();
-        for (auto i = nodePair.first; i != nodePair.second; ++i)
+        bool inside1 = blossomIndex[v1] != unmatched;
+        bool inside2 = blossomIndex[v2] != unmatched;
+        if (!inside1 && !inside2)
         {
-            if (!matching.has_node(*i))
-            {
-                v.emplace(*i);
-            }
+            ret.add_edge(v1, v2);
         }
-    }
-    else
-    {
-        bool firstIsV = true;
-        for (const auto& n : matching.edges_of_node(pathEnds[0].second))
+        else if (inside1 != inside2)
         {
-            if (n != pathEnds[0].first)
-            {
-                firstIsV = false;
-                break;
-            }
+            ret.add_edge(contractNode, inside1 ? v2 : v1);
         }
+    }
 
-        if (firstIsV)
-        {
-            v.emplace(pathEnds[0].second);
-            w.emplace(pathEnds[1].second);
-        }
-        else
-        {
-            v.emplace(pathEnds[1].second);
-            w.emplace(pathEnds[0].second);
-        }
+    return ret;
+}
+
+// Expands contractNode on the path back into the blossom, an odd cycle stored from
+// its base. The path leaves the blossom at the base, through the base's matched edge
+// or because the base is the free end, and enters it next to its other neighbor;
+// from there it follows the cycle to the base in the direction of even length, which
+// starts with a matched edge. Linear in the length of the lifted path.
+template<typename Graph>
+void liftPath(const Graph& graph, const std::vector<node_t>& mate, const std::vector<node_t>& cycle,
+        const std::vector<node_t>& blossomIndex, graph_t& path, node_t contractNode)
+{   
+    phase_timer timer("lift");
+    if (!path.has_node(contractNode))
+    {
+        return;
     }
 
-    assert(v && w);
-    std::deque<std::vector<node_t>> queue;
-    queue.push_back({v.value()});
-    while (!queue.empty())
+    node_t base = cycle[0];
+    std::size_t entry = 0;
+    for (const auto& n : path.edges_of_node(contractNode))
     {
-        auto entry = queue.front();
-        queue.pop_front();
-        if (entry.back() == w.value() && (entry.size() - 1) % 2 == 0)
+        if (n == mate[base])
         {
-            return entry;
+            path.add_edge(n, base);
+            continue;
         }
-        else if (entry.back() != w.value())
+
+        for (const auto& x : graph.edges_of_node(n))
         {
-            for (const auto& v2 : blossom.edges_of_node(entry.back()))
+            if (blossomIndex[x] != unmatched)
             {
-                if (std::find(entry.cbegin(), entry.cend(), v2) == entry.end())
-                {
-                    auto newEntry = entry;
-                    newEntry.push_back(v2);
-                    queue.push_back(newEntry);
-                }
+                path.add_edge(n, x);
+                entry = blossomIndex[x];
+                break;
             }
         }
     }
 
-    assert(false);
-    return std::vector<node_t>{};
-}
-
-void liftPath(const graph_t& graph, const graph_t& matching, const graph_t& blossom, graph_t& path, node_t contractNode)
-{   
-    if (path.has_node(contractNode))
+    path.remove_node(contractNode);
+    bool backward = entry % 2 == 0;
+    for (std::size_t i = entry; i != 0;)
     {
-        std::vector<std::pair<node_t, node_t>> pathEnds;
-        for (const auto& n : path.edges_of_node(contractNode))
-        {
-            for (const auto& n2 : graph.edges_of_node(n))
-            {
-                if (blossom.has_node(n2))
-                {
-                    path.add_edge(n, n2);
-                    pathEnds.push_back({n, n2});
-                    break;
-                }
-            }
-        }
-
-        path.remove_node(contractNode);
-        auto lifted = findAlternatingPath(matching, blossom, pathEnds);
-        for (std::size_t i = 0; i < lifted.size() - 1; ++i)
-        {
-            path.add_edge(lifted[i], lifted[i + 1]);
-        }
+        std::size_t next = backward ? i - 1 : (i + 1) % cycle.size();
+        path.add_edge(cycle[i], cycle[next]);
+        i = next;
     }
 }
 
-graph_t augmentingPath(const graph_t& graph, const graph_t& matching)
+template<typename Graph>
+graph_t augmentingPath(const Graph& graph, const std::vector<node_t>& mate, search_arena& arena, std::size_t depth = 0)
 {
-    forest_t trees;
-    graph_t unmarkedEdges;
-    std::deque<node_t> unmarkedNodes;
+    phase_timer timer("search");
+    solve_stats& stats = currentSolveStats();
+    search_level& level = arena.level(depth);
+    forest_t& trees = level.trees;
+    std::vector<node_t>& queue = level.queue;
+    // an edge is marked once either end has been scanned from, matched edges never are
+    std::vector<std::uint8_t>& scanned = level.scanned;
+    trees.clear();
+    queue.clear();
+    scanned.assign(mate.size(), 0);
     for (const auto& [v1, v2] : graph.edges())
     {
-        if (!matching.has_node(v1))
-        {
-            trees.add_node(v1);
-            unmarkedNodes.push_back(v1);
-        }
-
-        if (!matching.has_node(v2))
-        {
-            trees.add_node(v2);
-            unmarkedNodes.push_back(v2);
-        }
-
-        if (!matching.has_edge(v1, v2))
+        for (node_t v : {v1, v2})
         {
-            unmarkedEdges.add_edge(v1, v2);
+            if (mate[v] == unmatched && !trees.has(v))
+            {
+                trees.add_node(v);
+                queue.push_back(v);
+            }
         }
     }
    
-    while (!unmarkedNodes.empty())
+    for (std::size_t head = 0; head < queue.size(); ++head)
     {
-        node_t v = unmarkedNodes.front();
-        unmarkedNodes.pop_front();
-        if (trees.has(v) && trees.distance(v) % 2 == 0)
+        stats.searchQueuePeak = std::max(stats.searchQueuePeak, queue.size() - head);
+        node_t v = queue[head];
+        if (!scanned[v] && trees.has(v) && trees.distance(v) % 2 == 0)
         {
-            for (const auto& w : unmarkedEdges.edges_of_node(v))
+            scanned[v] = 1;
+            for (const auto& w : graph.edges_of_node(v))
             {
-                unmarkedEdges.remove_edge(v, w);
+                if (scanned[w] || w == mate[v])
+                {
+                    continue;
+                }
+
                 if (!trees.has(w))
                 {
-                    auto wEdges = matching.edges_of_node(w);
                     // if w was matched, there must be some node other than v attached
-                    assert(!wEdges.empty());
-                    node_t matchedNode = *(wEdges.begin());
+                    node_t matchedNode = mate[w];
+                    assert(matchedNode != unmatched);
                     trees.set_edge(v, w);
                     trees.set_edge(w, matchedNode);
-                    unmarkedNodes.push_back(matchedNode);
+                    queue.push_back(matchedNode);
                 }
                 else if (trees.distance(w) % 2 == 0)
                 {
@@ -216,57 +222,52 @@ graph_t augmentingPath(const graph_t& graph, const graph_t& matching)
                     }
                     else
                     {
-                        graph_t blossom{{v, w}};
+                        // the base is the deepest common ancestor, found where the paths to the root meet
                         auto pathV = trees.path(v);
                         auto pathW = trees.path(w);
-                        auto sortedPathV = pathV;
-                        std::sort(sortedPathV.begin(), sortedPathV.end());
-                        auto sortedPathW = pathW;
-                        std::sort(sortedPathW.begin(), sortedPathW.end()); 
-                        std::vector<node_t> intersection;
-                        std::set_intersection(sortedPathV.cbegin(), sortedPathV.cend(),
-                                sortedPathW.cbegin(), sortedPathW.cend(),
-                                std::back_inserter(intersection));
-                        node_t minCommon = 0;
-                        node_t minCommonDist = std::numeric_limits<node_t>::max();
-                        for (const auto& n : intersection)
+                        while (pathV.size() > 1 && pathW.size() > 1 && pathV[pathV.size() - 2] == pathW[pathW.size() - 2])
                         {
-                            auto dist = trees.distance(n);
-                            if (dist < minCommonDist)
-                            {
-                                minCommon = n;
-                                minCommonDist = dist;
-                            }
+                            pathV.pop_back();
+                            pathW.pop_back();
                         }
-                        std::unordered_set<node_t> toRemove(intersection.cbegin(), intersection.cend());
-                        toRemove.erase(minCommon);
-                        for (const auto& n : toRemove)
+
+                        std::vector<node_t>& cycle = level.cycle;
+                        cycle.assign(pathV.crbegin(), pathV.crend());
+                        cycle.insert(cycle.cend(), pathW.cbegin(), pathW.cend() - 1);
+                        assert(cycle.size() % 2 == 1);
+                        std::vector<node_t>& blossomIndex = level.blossomIndex;
+                        blossomIndex.assign(mate.size(), unmatched);
+                        for (std::size_t i = 0; i < cycle.size(); ++i)
                         {
-                            std::remove(pathV.begin(), pathV.end(), n);
-                            std::remove(pathW.begin(), pathW.end(), n);
+                            blossomIndex[cycle[i]] = static_cast<node_t>(i);
                         }
 
-                        for (std::size_t i = 0; i < pathV.size() - 1; ++i)
+                        ++stats.contractions;
+                        stats.maxBlossomDepth = std::max(stats.maxBlossomDepth, depth + 1);
+                        node_t contractNode = static_cast<node_t>(graph.num_nodes());
+                        while (graph.has_node(contractNode) || (contractNode < mate.size() && mate[contractNode] != unmatched))
                         {
-                            blossom.add_edge(pathV[i], pathV[i + 1]);
+                            ++contractNode;
                         }
 
-                        for (std::size_t i = 0; i < pathW.size() - 1; ++i)
+                        // only the base can be matched outside the blossom
+                        graph_t contractedGraph = contracted(graph, blossomIndex, contractNode);
+                        std::vector<node_t>& contractedMates = level.contractedMates;
+                        contractedMates.assign(mate.cbegin(), mate.cend());
+                        contractedMates.resize(std::max<std::size_t>(mate.size(), contractNode + 1), unmatched);
+                        for (const auto& x : cycle)
                         {
-                            blossom.add_edge(pathW[i], pathW[i + 1]);
+                            contractedMates[x] = unmatched;
                         }
 
-                        assert(blossom.num_edges() % 2 == 1);
-                        node_t contractNode = graph.num_nodes();
-                        while (graph.has_node(contractNode) || matching.has_node(contractNode))
+                        if (mate[cycle[0]] != unmatched)
                         {
-                            ++contractNode;
+                            contractedMates[contractNode] = mate[cycle[0]];
+                            contractedMates[mate[cycle[0]]] = contractNode;
                         }
 
-                        graph_t contractedGraph = contracted(graph, blossom, contractNode);
-                        graph_t contractedMatching = contracted(matching, blossom, contractNode);
-                        graph_t path = augmentingPath(contractedGraph, contractedMatching);
-                        liftPath(graph, matching, blossom, path, contractNode);
+                        graph_t path = augmentingPath(contractedGraph, contractedMates, arena, depth + 1);
+                        liftPath(graph, mate, cycle, blossomIndex, path, contractNode);
                         assert(!path.has_node(contractNode));
                         return path;
                     }
@@ -278,50 +279,611 @@ graph_t augmentingPath(const graph_t& graph, const graph_t& matching)
     return graph_t{};
 }
 
-void augmentMatching(graph_t& matching, const graph_t& path)
+// every path vertex ends up matched along its one unmatched path edge, so those are
+// found first and then written over the mate array in place
+void augmentMatching(std::vector<node_t>& mate, const graph_t& path)
 {
-    graph_t matchingWithoutPath = matching;
-    matchingWithoutPath.remove_edges_from(path);
-    graph_t pathWithoutMatching = path;
-    pathWithoutMatching.remove_edges_from(matching);
-    matching.clear();
-    matching.add_edges_from(matchingWithoutPath);
-    matching.add_edges_from(pathWithoutMatching);
+    phase_timer timer("augment");
+    auto flips = path.edges();
+    std::erase_if(flips, [&mate](const graph_t::edge& e) { return mate[e.v1] == e.v2; });
+    for (const auto& e : flips)
+    {
+        mate[e.v1] = e.v2;
+        mate[e.v2] = e.v1;
+    }
 }
 
-graph_t doBlossom(const graph_t& edges)
+template<typename T>
+graph_t matesToGraph(const std::vector<T>& mates)
 {
+    phase_timer timer("matching graph");
     graph_t matching;
-    auto path = augmentingPath(edges, matching);
-    while (!path.empty())
+    for (std::size_t v = 0; v < mates.size(); ++v)
     {
-        augmentMatching(matching, path);
-        path = augmentingPath(edges, matching);
+        if (mates[v] != std::numeric_limits<T>::max() && v < mates[v])
+        {
+            matching.add_edge(static_cast<node_t>(v), mates[v]);
+        }
     }
 
     return matching;
 }
 
-#ifdef __EMSCRIPTEN__
-graph_t inputValuesToGraph(const emscripten::val& edgeData)
+template<typename T>
+std::size_t countMatched(const std::vector<T>& mates)
 {
-    auto edgeNums = emscripten::convertJSArrayToNumberVector<node_t>(edgeData);
-#else
-graph_t inputValuesToGraph(const std::vector<node_t>& edgeNums)
+    return static_cast<std::size_t>(std::count_if(mates.begin(), mates.end(),
+        [](T v) { return v != std::numeric_limits<T>::max(); }));
+}
+
+template<typename Graph>
+std::vector<typename Graph::node_type> warmStart(const Graph& edges)
 {
+    phase_timer timer("greedy");
+    auto initialMates = greedyMatching(edges);
+    for (std::size_t v = 0; v < initialMates.size(); ++v)
+    {
+        currentSolveStats().greedyMatches += initialMates[v] != edmonds<Graph>::npos && v < initialMates[v];
+    }
+
+    return initialMates;
+}
+
+template<typename Matcher>
+void recordSearch(const Matcher& matcher, std::size_t augmentations)
+{
+    solve_stats& stats = currentSolveStats();
+    stats.augmentations = augmentations;
+    stats.contractions = matcher.num_contractions();
+    stats.maxBlossomDepth = matcher.max_depth();
+    stats.searchQueuePeak = matcher.queue_peak();
+}
+
+// one engine run over the input that can stop between augmentations, the state a
+// solve_task keeps from one step to the next
+class matching_run
+{
+    public:
+        virtual ~matching_run() = default;
+
+        // up to budget augmentations, true once the matching is maximum
+        virtual bool step(std::size_t budget) = 0;
+
+        // matched nodes of the input graph, the matches kernel reductions add included
+        virtual std::size_t matched_nodes() const = 0;
+
+        // mates by input node, unmatched where free
+        virtual std::vector<node_t> mates() const = 0;
+};
+
+// open meshes have boundary faces of dual degree 1 and 2, those are reduced away so
+// the engines only search the kernel
+template<typename T>
+class kernel_run : public matching_run
+{
+    std::optional<matching_kernel<T>> kernel;
+
+    protected:
+        explicit kernel_run(std::optional<matching_kernel<T>> reductions): kernel(std::move(reductions)) {}
+
+        std::size_t reducedMatches() const
+        {
+            return kernel ? kernel->num_pendants() + kernel->num_folds() : 0;
+        }
+
+        std::vector<node_t> expanded(std::vector<T> mates) const
+        {
+            if (kernel)
+            {
+                phase_timer timer("kernel expand");
+                mates.resize(kernel->num_nodes(), matching_kernel<T>::npos);
+                mates = kernel->expand(mates);
+            }
+
+            if constexpr (std::is_same_v<T, node_t>)
+            {
+                return mates;
+            }
+            else
+            {
+                std::vector<node_t> wide(mates.size());
+                std::transform(mates.begin(), mates.end(), wide.begin(),
+                    [](T v) { return v == matching_kernel<T>::npos ? unmatched : node_t{v}; });
+                return wide;
+            }
+        }
+};
+
+template<typename Graph>
+class edmonds_run : public kernel_run<typename Graph::node_type>
+{
+    using T = typename Graph::node_type;
+
+    Graph graph;
+    matching_engine engine;
+    // the parallel engine only runs whole, from the warm start kept here
+    std::optional<edmonds<Graph>> matcher;
+    std::vector<T> parallelMates;
+    std::size_t cursor;
+    std::size_t augmentations;
+
+    public:
+        edmonds_run(std::optional<matching_kernel<T>> kernel, Graph edges, matching_engine matchingEngine):
+            kernel_run<T>(std::move(kernel)), graph(std::move(edges)), engine(matchingEngine), matcher(),
+            parallelMates(), cursor(0), augmentations(0)
+        {
+#ifdef BLOSSOM_THREADS
+            if (engine == matching_engine::parallel)
+            {
+                parallelMates = warmStart(graph);
+                return;
+            }
 #endif
+            matcher.emplace(graph, warmStart(graph));
+        }
+
+        bool step(std::size_t budget) override
+        {
+            phase_timer timer("search");
+#ifdef BLOSSOM_THREADS
+            if (engine == matching_engine::parallel)
+            {
+                parallel_edmonds<Graph> parallelMatcher(graph, std::move(parallelMates), solverThreads());
+                recordSearch(parallelMatcher, parallelMatcher.run());
+                parallelMates = parallelMatcher.mates();
+                return true;
+            }
+#endif
+
+            bool finished = false;
+            if (engine == matching_engine::phased)
+            {
+                for (std::size_t found = 0; found < budget && !finished;)
+                {
+                    std::size_t phaseFound = matcher->phase();
+                    found += phaseFound;
+                    augmentations += phaseFound;
+                    finished = phaseFound == 0;
+                }
+            }
+            else
+            {
+                augmentations += matcher->run_slice(cursor, budget);
+                finished = cursor == matcher->mates().size();
+            }
+
+            recordSearch(*matcher, augmentations);
+            return finished;
+        }
+
+        std::size_t matched_nodes() const override
+        {
+            std::size_t kernelMatched = matcher ? 2 * matcher->size() : countMatched(parallelMates);
+            return kernelMatched + 2 * this->reducedMatches();
+        }
+
+        std::vector<node_t> mates() const override
+        {
+            return this->expanded(matcher ? matcher->mates() : parallelMates);
+        }
+};
+
+// the legacy engine adds nodes for contracted blossoms, so it always runs 32 bits wide
+class contraction_run : public kernel_run<node_t>
+{
+    csr_t graph;
+    std::vector<node_t> mate;
+    search_arena arena;
+    std::size_t matchedEdges;
+
+    public:
+        contraction_run(std::optional<matching_kernel<node_t>> kernel, csr_t edges):
+            kernel_run<node_t>(std::move(kernel)), graph(std::move(edges)), mate(warmStart(graph)), arena(),
+            matchedEdges(countMatched(mate) / 2)
+        {
+        }
+
+        bool step(std::size_t budget) override
+        {
+            for (std::size_t i = 0; i < budget; ++i)
+            {
+                auto path = augmentingPath(graph, mate, arena);
+                if (path.empty())
+                {
+                    return true;
+                }
+
+                ++currentSolveStats().augmentations;
+                ++matchedEdges;
+                augmentMatching(mate, path);
+            }
+
+            return false;
+        }
+
+        std::size_t matched_nodes() const override
+        {
+            return 2 * (matchedEdges + reducedMatches());
+        }
+
+        std::vector<node_t> mates() const override
+        {
+            return expanded(mate);
+        }
+};
+
+template<typename T>
+std::unique_ptr<matching_run> startMatching(csr_graph<T> edges, matching_engine engine)
+{
+    bool reducible = false;
+    {
+        phase_timer timer("classify");
+        reducible = matching_kernel<T>::reducible(edges);
+    }
+
+    std::optional<matching_kernel<T>> kernel;
+    if (reducible)
+    {
+        phase_timer timer("kernel");
+        kernel.emplace(edges);
+        edges = csr_graph<T>(kernel->edges());
+        solve_stats& stats = currentSolveStats();
+        stats.pendantMatches = kernel->num_pendants();
+        stats.folds = kernel->num_folds();
+        stats.kernelNodes = kernel->num_nodes();
+    }
+
+    if constexpr (std::is_same_v<T, node_t>)
+    {
+        if (engine == matching_engine::contraction)
+        {
+            return std::make_unique<contraction_run>(std::move(kernel), std::move(edges));
+        }
+    }
+
+    // watertight meshes give bridgeless cubic duals, which Petersen's theorem says have
+    // a perfect matching, so every search from a free vertex is bound to succeed
+    assert(engine != matching_engine::contraction);
+    bool cubic = false;
+    {
+        phase_timer timer("classify");
+        cubic = isBridgelessCubic(edges);
+    }
+
+    if (cubic)
+    {
+        currentSolveStats().cubic = true;
+        std::optional<cubic_graph<T>> cubicEdges;
+        {
+            phase_timer timer("cubic layout");
+            cubicEdges.emplace(edges);
+        }
+
+        return std::make_unique<edmonds_run<cubic_graph<T>>>(std::move(kernel), std::move(*cubicEdges), engine);
+    }
+
+    return std::make_unique<edmonds_run<csr_graph<T>>>(std::move(kernel), std::move(edges), engine);
+}
+
+template<typename T>
+std::unique_ptr<matching_run> startNarrowed(std::span<const node_t> edgeNums, matching_engine engine)
+{
+    std::optional<csr_graph<T>> edges;
+    {
+        phase_timer timer("input");
+        edges.emplace(edgeNums);
+    }
+
+    currentSolveStats().nodeBytes = sizeof(T);
+    return startMatching(std::move(*edges), engine);
+}
+
+// Inputs under 65535 nodes are solved with 16 bit ids, which halves every index
+// array the engines keep (the largest value of the id type stands for unmatched).
+// Anything else, and the legacy engine, runs with node_t.
+std::unique_ptr<matching_run> startMatching(std::span<const node_t> edgeNums, matching_engine engine)
+{
+    assert(edgeNums.size() % 2 == 0);
+    constexpr node_t narrowLimit = std::numeric_limits<std::uint16_t>::max();
+    bool narrow = engine != matching_engine::contraction
+        && std::all_of(edgeNums.begin(), edgeNums.end(), [](node_t v) { return v < narrowLimit; });
+    if (narrow)
+    {
+        return startNarrowed<std::uint16_t>(edgeNums, engine);
+    }
+
+    return startNarrowed<node_t>(edgeNums, engine);
+}
+
+std::vector<node_t> findMates(std::span<const node_t> edgeNums, matching_engine engine)
+{
+    auto run = startMatching(edgeNums, engine);
+    while (!run->step(std::numeric_limits<std::size_t>::max()))
+    {
+    }
+
+    return run->mates();
+}
+
+graph_t findMatching(std::span<const node_t> edgeNums, matching_engine engine)
+{
+    return matesToGraph(findMates(edgeNums, engine));
+}
+
+// A maximum matching of a patch leaves nodes free anywhere in it, and augmenting
+// across the cut from there takes paths as long as the patch is wide. Flipping an
+// even alternating path from a free node to a node on the cut keeps the matching's
+// size and leaves the cut node free instead, so the repair only has to look near
+// the cut. The search ignores blossoms, which only means some free nodes stay put.
+void moveFreeToCut(const csr_t& graph, std::vector<node_t>& mate, std::span<const std::uint8_t> onCut)
+{
+    phase_timer timer("free to cut");
+    std::vector<node_t> parent(mate.size(), unmatched);
+    std::vector<node_t> rootOf(mate.size(), unmatched);
+    std::vector<std::uint8_t> moved(mate.size(), 0);
+    std::vector<node_t> queue;
+    for (std::size_t v = 0; v < mate.size(); ++v)
+    {
+        if (mate[v] == unmatched && !onCut[v] && graph.degree(static_cast<node_t>(v)) != 0)
+        {
+            rootOf[v] = static_cast<node_t>(v);
+            queue.push_back(static_cast<node_t>(v));
+        }
+    }
+
+    for (std::size_t head = 0; head < queue.size(); ++head)
+    {
+        node_t v = queue[head];
+        for (const auto& w : graph.edges_of_node(v))
+        {
+            if (moved[rootOf[v]])
+            {
+                break;
+            }
+
+            node_t x = mate[w];
+            if (rootOf[w] != unmatched || x == unmatched || rootOf[x] != unmatched)
+            {
+                continue;
+            }
+
+            rootOf[w] = rootOf[x] = rootOf[v];
+            parent[w] = v;
+            parent[x] = w;
+            if (!onCut[x])
+            {
+                queue.push_back(x);
+                continue;
+            }
+
+            moved[rootOf[v]] = 1;
+            mate[x] = unmatched;
+            for (node_t even = x; even != rootOf[v];)
+            {
+                node_t odd = parent[even];
+                even = parent[odd];
+                mate[odd] = even;
+                mate[even] = odd;
+            }
+        }
+    }
+}
+
+// nodes within hops of a cut edge, then their mates, so every matched node of the
+// region is matched inside it and augmenting there keeps the rest of the matching
+std::vector<std::uint8_t> repairRegion(std::span<const node_t> edgeNums, const std::vector<node_t>& mate,
+        std::size_t patchNodes, std::size_t hops)
+{
+    // the hop a node was reached at plus 1, 0 outside; one pass over the edges per hop
+    std::vector<std::uint8_t> level(mate.size(), 0);
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        if (edgeNums[i] / patchNodes != edgeNums[i + 1] / patchNodes)
+        {
+            level[edgeNums[i]] = level[edgeNums[i + 1]] = 1;
+        }
+    }
+
+    hops = std::min<std::size_t>(hops, std::numeric_limits<std::uint8_t>::max() - 1);
+    for (std::uint8_t hop = 1; hop <= hops; ++hop)
+    {
+        for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+        {
+            node_t v1 = edgeNums[i];
+            node_t v2 = edgeNums[i + 1];
+            if (level[v1] != 0 && level[v1] <= hop && level[v2] == 0)
+            {
+                level[v2] = hop + 1;
+            }
+            else if (level[v2] != 0 && level[v2] <= hop && level[v1] == 0)
+            {
+                level[v1] = hop + 1;
+            }
+        }
+    }
+
+    for (std::size_t v = 0; v < mate.size(); ++v)
+    {
+        if (level[v] != 0 && mate[v] != unmatched && level[mate[v]] == 0)
+        {
+            level[mate[v]] = std::numeric_limits<std::uint8_t>::max();
+        }
+    }
+
+    return level;
+}
+
+// solves the region around the cuts again from the patch matching, returning the
+// number of nodes in it
+std::size_t repairBoundary(std::span<const node_t> edgeNums, std::vector<node_t>& mate, std::size_t patchNodes,
+        std::size_t hops)
+{
+    phase_timer timer("boundary repair");
+    auto region = repairRegion(edgeNums, mate, patchNodes, hops);
+    std::vector<node_t> localIds(mate.size(), unmatched);
+    std::vector<node_t> globalIds;
+    for (std::size_t v = 0; v < mate.size(); ++v)
+    {
+        if (region[v] != 0)
+        {
+            localIds[v] = static_cast<node_t>(globalIds.size());
+            globalIds.push_back(static_cast<node_t>(v));
+        }
+    }
+
+    std::vector<node_t> regionEdges;
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        if (region[edgeNums[i]] != 0 && region[edgeNums[i + 1]] != 0)
+        {
+            regionEdges.push_back(localIds[edgeNums[i]]);
+            regionEdges.push_back(localIds[edgeNums[i + 1]]);
+        }
+    }
+
+    csr_t graph(regionEdges);
+    std::vector<node_t> localMates(graph.num_nodes(), unmatched);
+    for (std::size_t k = 0; k < localMates.size(); ++k)
+    {
+        node_t m = mate[globalIds[k]];
+        localMates[k] = m == unmatched ? unmatched : localIds[m];
+    }
+
+    edmonds<csr_t> matcher(graph, std::move(localMates));
+    recordSearch(matcher, matcher.run());
+    for (std::size_t k = 0; k < matcher.mates().size(); ++k)
+    {
+        node_t m = matcher.mates()[k];
+        mate[globalIds[k]] = m == unmatched ? unmatched : globalIds[m];
+    }
+
+    return globalIds.size();
+}
+
+std::vector<node_t> findPartitionedMates(std::span<const node_t> edgeNums, const partition_options& options,
+        matching_engine engine)
+{
     assert(edgeNums.size() % 2 == 0);
-    graph_t edges;
-    for (std::size_t i = 0; i < edgeNums.size(); i += 2)
+    std::optional<phase_timer> timer(std::in_place, "partition");
+    std::size_t numNodes = edgeNums.empty() ? 0 : *std::max_element(edgeNums.begin(), edgeNums.end()) + std::size_t{1};
+    std::size_t patchNodes = std::max<std::size_t>(options.patchNodes, 2);
+    std::size_t numPatches = (numNodes + patchNodes - 1) / patchNodes;
+
+    // the edges inside each patch with patch local ids, grouped by a counting sort
+    std::vector<std::size_t> patchBegin(numPatches + 1, 0);
+    std::vector<std::uint8_t> onCut(numNodes, 0);
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
     {
-        edges.add_edge(edgeNums[i], edgeNums[i + 1]);
+        std::size_t patch = edgeNums[i] / patchNodes;
+        bool inside = patch == edgeNums[i + 1] / patchNodes;
+        patchBegin[patch + 1] += inside;
+        onCut[edgeNums[i]] |= !inside;
+        onCut[edgeNums[i + 1]] |= !inside;
     }
 
-    return edges;
+    std::partial_sum(patchBegin.begin(), patchBegin.end(), patchBegin.begin());
+    std::vector<node_t> patchEdges(2 * patchBegin.back());
+    std::vector<std::size_t> fill(patchBegin.begin(), patchBegin.end() - 1);
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        std::size_t patch = edgeNums[i] / patchNodes;
+        if (patch == edgeNums[i + 1] / patchNodes)
+        {
+            node_t base = static_cast<node_t>(patch * patchNodes);
+            patchEdges[2 * fill[patch]] = edgeNums[i] - base;
+            patchEdges[2 * fill[patch] + 1] = edgeNums[i + 1] - base;
+            ++fill[patch];
+        }
+    }
+
+    // patches write disjoint ranges of mate; the parallelism is across patches, so
+    // the parallel engine runs as plain edmonds inside them
+    timer.emplace("patches");
+    matching_engine patchEngine = engine == matching_engine::parallel ? matching_engine::edmonds : engine;
+    std::vector<node_t> mate(numNodes, unmatched);
+    auto solvePatch = [&](std::size_t patch)
+    {
+        auto local = std::span<const node_t>(patchEdges).subspan(2 * patchBegin[patch],
+            2 * (patchBegin[patch + 1] - patchBegin[patch]));
+        node_t base = static_cast<node_t>(patch * patchNodes);
+        csr_t graph(local);
+        auto patchMates = findMates(local, patchEngine);
+        patchMates.resize(graph.num_nodes(), unmatched);
+
+        moveFreeToCut(graph, patchMates, std::span<const std::uint8_t>(onCut).subspan(base, patchMates.size()));
+        for (std::size_t v = 0; v < patchMates.size(); ++v)
+        {
+            mate[base + v] = patchMates[v] == unmatched ? unmatched : base + patchMates[v];
+        }
+    };
+
+#ifdef BLOSSOM_THREADS
+    std::atomic<std::size_t> nextPatch{0};
+    auto work = [&]()
+    {
+        for (std::size_t patch = nextPatch++; patch < numPatches; patch = nextPatch++)
+        {
+            solvePatch(patch);
+        }
+    };
+
+    std::size_t numThreads = std::min(numPatches, solverThreads());
+    std::vector<std::thread> threads;
+    for (std::size_t k = 1; k < numThreads; ++k)
+    {
+        threads.emplace_back(work);
+    }
+
+    work();
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+#else
+    for (std::size_t patch = 0; patch < numPatches; ++patch)
+    {
+        solvePatch(patch);
+    }
+#endif
+    timer.reset();
+
+    // the patch solves counted into the stats of whichever thread ran them, so the
+    // engine counters are left to the repair
+    solve_stats& stats = currentSolveStats();
+    stats.greedyMatches = stats.pendantMatches = stats.folds = stats.kernelNodes = 0;
+    stats.augmentations = stats.contractions = stats.maxBlossomDepth = stats.searchQueuePeak = 0;
+    stats.cubic = false;
+    stats.nodeBytes = sizeof(node_t);
+    stats.patches = numPatches;
+    if (numPatches > 1)
+    {
+        stats.boundaryNodes = repairBoundary(edgeNums, mate, patchNodes, options.repairHops);
+    }
+
+    bool freeEdge = false;
+    for (std::size_t i = 0; i + 1 < edgeNums.size() && !freeEdge; i += 2)
+    {
+        freeEdge = edgeNums[i] != edgeNums[i + 1] && (mate[edgeNums[i]] == unmatched || mate[edgeNums[i + 1]] == unmatched);
+    }
+
+    // the free nodes left are few and far apart, phases grow all their trees at once
+    // where one search per root would cover the same ground again and again
+    if (options.exact && freeEdge)
+    {
+        phase_timer exactTimer("exact pass");
+        csr_t graph(edgeNums);
+        mate.resize(graph.num_nodes());
+        edmonds<csr_t> matcher(graph, std::move(mate));
+        stats.augmentations += matcher.run_phases();
+        mate = matcher.mates();
+    }
+
+    return mate;
 }
 
 std::vector<node_t> graphToOutputValues(const graph_t& matching)
 {
+    phase_timer timer("output");
     std::vector<node_t> edgeNums;
     for (const auto& [v1, v2] : matching.edges())
     {
@@ -332,106 +894,505 @@ std::vector<node_t> graphToOutputValues(const graph_t& matching)
     return edgeNums;
 }
 
-#ifdef __EMSCRIPTEN__
-std::vector<node_t> blossom(const emscripten::val& edgeData)
-#else
-std::vector<node_t> blossom(const std::vector<node_t>& edgeData)
-#endif
+std::vector<node_t> blossom(std::span<const node_t> edgeData, matching_engine engine)
 { 
-    auto matching = doBlossom(inputValuesToGraph(edgeData));
+    solve_scope scope("blossom");
+    auto matching = findMatching(edgeData, engine);
     return graphToOutputValues(matching);
 }
 
-#ifdef __EMSCRIPTEN__
-std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycle(const emscripten::val& edgeData)
-#else
-std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycle(const std::vector<node_t>& edgeData)
-#endif
+// weights has one entry per edge pair of edgeNums; among the maximum matchings the
+// lightest one is returned, so a perfect matching whenever the graph has one
+std::vector<node_t> findWeightedMates(std::span<const node_t> edgeNums, std::span<const std::int64_t> weights)
 {
-    auto dualGraph = inputValuesToGraph(edgeData);
-    auto matching = doBlossom(dualGraph);
-
-    dualGraph.remove_edges_from(matching);
-    forest_t cycles;
-    auto nodesPair = dualGraph.nodes();
-    std::unordered_set<node_t> remainingVerts(nodesPair.first, nodesPair.second);
-    while (!remainingVerts.empty())
-    {
-        node_t start = *remainingVerts.begin();
-        remainingVerts.erase(start);
-        cycles.add_node(start);
-        std::deque<node_t> queue;
-        queue.push_back(start);
-        while (!queue.empty())
-        {
-            node_t n = queue.front();
-            queue.pop_front();
-            for (const auto& v : dualGraph.edges_of_node(n))
+    assert(edgeNums.size() == 2 * weights.size());
+    std::optional<phase_timer> timer(std::in_place, "weighted setup");
+    weighted_matching<node_t> matcher(edgeNums, weights);
+    timer.emplace("weighted search");
+    std::size_t augmentations = matcher.run();
+    timer.reset();
+
+    solve_stats& stats = currentSolveStats();
+    stats.greedyMatches = matcher.greedy_matches();
+    stats.augmentations = augmentations;
+    stats.contractions = matcher.num_contractions();
+    return matcher.mates();
+}
+
+// The edges the matching leaves form a cycle cover on cubic graphs, merged here into
+// one cycle across matched edges. The cover is flat adjacency, the slots of node v
+// from offsets[v] to offsets[v + 1] and two slots per twin after them, and its cycles
+// are union-find sets with path halving, so labeling and merging take time linear in
+// the edges however many cycles the cover falls into. A merge needs both ends of the
+// matched edge on exactly two cover edges; where the input is not cubic, edges whose
+// ends are not are left alone and the cover stays split there.
+std::pair<std::vector<node_t>, std::vector<node_t>> cycleFromMatching(std::span<const node_t> edgeNums,
+        std::span<const node_t> mate)
+{
+    std::optional<phase_timer> timer(std::in_place, "cycle cover");
+    auto matched = [&](node_t v1, node_t v2)
+    {
+        return v1 < mate.size() && mate[v1] == v2;
+    };
+
+    // self loops count, a node with nothing else must not share its id with a twin
+    std::size_t bound = 0;
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        bound = std::max<std::size_t>(bound, std::max(edgeNums[i], edgeNums[i + 1]) + std::size_t{1});
+    }
+
+    std::vector<std::size_t> offsets(bound + 1, 0);
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        node_t v1 = edgeNums[i];
+        node_t v2 = edgeNums[i + 1];
+        if (v1 != v2 && !matched(v1, v2))
+        {
+            ++offsets[v1 + 1];
+            ++offsets[v2 + 1];
+        }
+    }
+
+    for (std::size_t v = 1; v < offsets.size(); ++v)
+    {
+        offsets[v] += offsets[v - 1];
+    }
+
+    std::vector<node_t> slots(offsets[bound]);
+    std::vector<std::size_t> fill(offsets.cbegin(), offsets.cend() - 1);
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        node_t v1 = edgeNums[i];
+        node_t v2 = edgeNums[i + 1];
+        if (v1 != v2 && !matched(v1, v2))
+        {
+            slots[fill[v1]++] = v2;
+            slots[fill[v2]++] = v1;
+        }
+    }
+
+    // repeated edges out, compacting in place; nodes have few slots to sort
+    std::size_t numSlots = 0;
+    for (std::size_t v = 0; v < bound; ++v)
+    {
+        auto first = slots.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+        auto last = slots.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]);
+        std::sort(first, last);
+        offsets[v] = numSlots;
+        for (auto it = first; it != last; ++it)
+        {
+            if (it == first || *it != *(it - 1))
             {
-                cycles.set_edge(start, v);
-                if (remainingVerts.erase(v))
-                {
-                    queue.push_back(v);
-                }
+                slots[numSlots++] = *it;
             }
         }
     }
-   
+
+    offsets[bound] = numSlots;
+    slots.resize(numSlots);
+
+    std::vector<node_t> cycleOf(bound);
+    std::vector<node_t> cycleSize(bound, 1);
+    std::iota(cycleOf.begin(), cycleOf.end(), node_t{0});
+    auto find = [&](node_t v)
+    {
+        while (cycleOf[v] != v)
+        {
+            cycleOf[v] = cycleOf[cycleOf[v]];
+            v = cycleOf[v];
+        }
+
+        return v;
+    };
+
+    auto unite = [&](node_t v1, node_t v2)
+    {
+        v1 = find(v1);
+        v2 = find(v2);
+        if (v1 == v2)
+        {
+            return false;
+        }
+
+        if (cycleSize[v1] < cycleSize[v2])
+        {
+            std::swap(v1, v2);
+        }
+
+        cycleOf[v2] = v1;
+        cycleSize[v1] += cycleSize[v2];
+        return true;
+    };
+
+    for (node_t v = 0; v < bound; ++v)
+    {
+        for (std::size_t k = offsets[v]; k < offsets[v + 1]; ++k)
+        {
+            unite(v, slots[k]);
+        }
+    }
+
+    std::size_t largestCycle = 0;
+    for (node_t v = 0; v < bound; ++v)
+    {
+        largestCycle = std::max<std::size_t>(largestCycle, cycleOf[v] == v ? cycleSize[v] : 0);
+    }
+
+    currentSolveStats().cycleQueuePeak = std::max(currentSolveStats().cycleQueuePeak, largestCycle);
+
+    timer.emplace("cycle merge");
+    // v1 v2 matched in different cycles: the cover edges v1 n1 and v2 n2 become v1 v2,
+    // n1 to the twin of v1, n2 to the twin of v2 and the two twins, one cycle through all
+    std::vector<node_t> twinLinks;
     std::vector<node_t> subdivisions;
-    if (cycles.num_trees() != 1)
+    auto degree = [&](node_t v)
+    {
+        return offsets[v + 1] - offsets[v];
+    };
+
+    auto relink = [&](node_t v, node_t from, node_t to)
+    {
+        node_t* first = v < bound ? slots.data() + offsets[v] : twinLinks.data() + 2 * (v - bound);
+        node_t* last = v < bound ? slots.data() + offsets[v + 1] : first + 2;
+        *std::find(first, last, from) = to;
+    };
+
+    for (node_t v1 = 0; v1 < std::min<std::size_t>(bound, mate.size()); ++v1)
     {
-        node_t nextNewNode = *std::max_element(nodesPair.first, nodesPair.second) + 1;
-        for (const auto& [v1, v2] : matching.edges())
+        node_t v2 = mate[v1];
+        if (v2 == unmatched || v2 < v1 || v2 >= bound || degree(v1) != 2 || degree(v2) != 2 || !unite(v1, v2))
         {
-            if (!cycles.same_tree(v1, v2))
+            continue;
+        }
+
+        node_t twin1 = static_cast<node_t>(bound + twinLinks.size() / 2);
+        node_t twin2 = twin1 + 1;
+        node_t n1 = std::exchange(slots[offsets[v1] + 1], v2);
+        node_t n2 = std::exchange(slots[offsets[v2] + 1], v1);
+        twinLinks.insert(twinLinks.end(), {n1, twin2, n2, twin1});
+        relink(n1, v1, twin1);
+        relink(n2, v2, twin2);
+
+        subdivisions.push_back(v1);
+        subdivisions.push_back(twin1);
+        subdivisions.push_back(v2);
+        subdivisions.push_back(twin2);
+    }
+
+    timer.emplace("output");
+    std::vector<node_t> cycle;
+    cycle.reserve(slots.size() + twinLinks.size());
+    for (node_t v = 0; v < bound; ++v)
+    {
+        for (std::size_t k = offsets[v]; k < offsets[v + 1]; ++k)
+        {
+            if (v < slots[k])
             {
-                auto neighbors1Set = dualGraph.edges_of_node(v1);
-                auto neighbors2Set = dualGraph.edges_of_node(v2);
-                std::vector<node_t> neighbors1(neighbors1Set.cbegin(), neighbors1Set.cend());
-                std::vector<node_t> neighbors2(neighbors2Set.cbegin(), neighbors2Set.cend());
-                assert(neighbors1.size() == 2);
-                assert(neighbors2.size() == 2);
+                cycle.push_back(v);
+                cycle.push_back(slots[k]);
+            }
+        }
+    }
+
+    for (std::size_t k = 0; k < twinLinks.size(); ++k)
+    {
+        node_t twin = static_cast<node_t>(bound + k / 2);
+        if (twin < twinLinks[k])
+        {
+            cycle.push_back(twin);
+            cycle.push_back(twinLinks[k]);
+        }
+    }
+
+    timer.reset();
+    return {std::move(cycle), std::move(subdivisions)};
+}
+
+std::pair<std::vector<node_t>, std::vector<node_t>> solveHamiltonianCycle(std::span<const node_t> edgeNums,
+        matching_engine engine)
+{
+    return cycleFromMatching(edgeNums, findMates(edgeNums, engine));
+}
+
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycle(std::span<const node_t> edgeData,
+        matching_engine engine)
+{
+    solve_scope scope("hamiltonianCycle");
+    return solveHamiltonianCycle(edgeData, engine);
+}
 
-                node_t newNode1 = nextNewNode++;
-                node_t newNode2 = nextNewNode++;
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycleFromMatching(std::span<const node_t> edgeData,
+        std::span<const node_t> matching)
+{
+    solve_scope scope("hamiltonianCycleFromMatching");
+    assert(matching.size() % 2 == 0);
+    std::vector<node_t> mate(matching.empty() ? 0 : *std::max_element(matching.begin(), matching.end()) + std::size_t{1},
+        unmatched);
+    for (std::size_t i = 0; i + 1 < matching.size(); i += 2)
+    {
+        mate[matching[i]] = matching[i + 1];
+        mate[matching[i + 1]] = matching[i];
+    }
 
-                cycles.set_edge(v1, cycles.root(v2));
-                cycles.set_edge(v1, newNode1);
-                cycles.set_edge(v2, newNode2);
-                dualGraph.remove_edge(v1, neighbors1[1]);
-                dualGraph.remove_edge(v2, neighbors2[1]);
-                dualGraph.add_edge(v1, v2);
-                dualGraph.add_edge(newNode1, neighbors1[1]);
-                dualGraph.add_edge(newNode2, neighbors2[1]);
-                dualGraph.add_edge(newNode1, newNode2);
+    return cycleFromMatching(edgeData, mate);
+}
 
-                subdivisions.push_back(v1);
-                subdivisions.push_back(newNode1);
-                subdivisions.push_back(v2);
-                subdivisions.push_back(newNode2);
-            } 
+std::vector<node_t> blossomPartitioned(std::span<const node_t> edgeData, const partition_options& options,
+        matching_engine engine)
+{
+    solve_scope scope("blossomPartitioned");
+    auto mate = findPartitionedMates(edgeData, options, engine);
+    phase_timer timer("output");
+    std::vector<node_t> edgeNums;
+    for (std::size_t v = 0; v < mate.size(); ++v)
+    {
+        if (mate[v] != unmatched && v < mate[v])
+        {
+            edgeNums.push_back(static_cast<node_t>(v));
+            edgeNums.push_back(mate[v]);
         }
     }
 
-    return {graphToOutputValues(dualGraph), subdivisions};
+    return edgeNums;
+}
+
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCyclePartitioned(std::span<const node_t> edgeData,
+        const partition_options& options, matching_engine engine)
+{
+    solve_scope scope("hamiltonianCyclePartitioned");
+    return cycleFromMatching(edgeData, findPartitionedMates(edgeData, options, engine));
+}
+
+std::vector<node_t> blossomWeighted(std::span<const node_t> edgeData, std::span<const std::int64_t> weights)
+{
+    solve_scope scope("blossomWeighted");
+    return graphToOutputValues(matesToGraph(findWeightedMates(edgeData, weights)));
 }
 
-#ifdef __EMSCRIPTEN__
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycleWeighted(std::span<const node_t> edgeData,
+        std::span<const std::int64_t> weights)
+{
+    solve_scope scope("hamiltonianCycleWeighted");
+    return cycleFromMatching(edgeData, findWeightedMates(edgeData, weights));
+}
+
+cycle_order solveHamiltonianOrder(std::span<const node_t> edgeNums, matching_engine engine)
+{
+    auto [cycle, subdivisions] = solveHamiltonianCycle(edgeNums, engine);
+    phase_timer timer("order");
+    std::size_t bound = 0;
+    for (const auto& v : edgeNums)
+    {
+        bound = std::max(bound, static_cast<std::size_t>(v) + 1);
+    }
 
-using hCycleRetType = std::invoke_result_t<decltype(hamiltonianCycle), const emscripten::val&>;
+    auto order = cycleOrder<node_t>(cycle);
+    appendUncovered<node_t>(order, bound, edgeNums);
+    return {std::move(order), std::move(subdivisions)};
+}
 
-EMSCRIPTEN_BINDINGS(module)
+triangle_strip solveTriangleStrip(std::span<const node_t> triangles, std::span<const node_t> edgeNums,
+        matching_engine engine)
 {
-    emscripten::function("blossom", &blossom);
-    emscripten::function("hamiltonianCycle", &hamiltonianCycle);
-    
-    emscripten::value_object<hCycleRetType>("pair<vector<node_t>,vector<node_t>>")
-        .field("graph", &hCycleRetType::first)
-        .field("subdivisions", &hCycleRetType::second)
-    ;
-    
-    emscripten::register_vector<node_t>("vector<node_t>");
+    assert(triangles.size() % 3 == 0);
+    auto [cycle, subdivisions] = solveHamiltonianCycle(edgeNums, engine);
+    phase_timer timer("strip");
+
+    numberTwinsFrom(triangles.size() / 3, cycle, subdivisions);
+    triangle_strip ret;
+    auto nodeTriangles = splitSubdivided<node_t>(triangles, subdivisions, cycle, ret.midpoints);
+    auto order = cycleOrder<node_t>(cycle);
+    std::erase_if(order, [&nodeTriangles](node_t v) { return v >= nodeTriangles.size() / 3; });
+    appendUncovered<node_t>(order, nodeTriangles.size() / 3, edgeNums);
+    ret.indices = stripFromOrder<node_t>(nodeTriangles, order);
+    return ret;
 }
 
-#endif
+void numberTwinsFrom(std::size_t numNodes, std::vector<node_t>& cycle, std::vector<node_t>& subdivisions)
+{
+    if (subdivisions.empty() || subdivisions[1] >= numNodes)
+    {
+        return;
+    }
+
+    // nodes at or past the first twin have no edges, so every such id is a twin
+    node_t firstTwin = subdivisions[1];
+    auto shift = static_cast<node_t>(numNodes - firstTwin);
+    for (auto* values : {&cycle, &subdivisions})
+    {
+        for (auto& v : *values)
+        {
+            v += v >= firstTwin ? shift : 0;
+        }
+    }
+}
+
+cycle_order hamiltonianOrder(std::span<const node_t> edgeData, matching_engine engine)
+{
+    solve_scope scope("hamiltonianOrder");
+    return solveHamiltonianOrder(edgeData, engine);
+}
+
+triangle_strip triangleStrip(std::span<const node_t> triangles, std::span<const node_t> edgeData,
+        matching_engine engine)
+{
+    solve_scope scope("triangleStrip");
+    return solveTriangleStrip(triangles, edgeData, engine);
+}
+
+solve_task::solve_task(std::span<const node_t> edgeData, bool hamiltonianCycle, matching_engine matchingEngine):
+    edgeNums(edgeData.begin(), edgeData.end()), hamiltonian(hamiltonianCycle), engine(matchingEngine), engineRun(),
+    matchingValues(), cycleValues(), subdivisionValues(), totalNodes(0), currentStatus(task_status::running),
+    cancelRequested(false), deadline(std::chrono::steady_clock::time_point::max()), matchedNodes(0)
+{
+    assert(edgeNums.size() % 2 == 0);
+    std::vector<bool> hasEdge;
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        if (edgeNums[i] == edgeNums[i + 1])
+        {
+            continue;
+        }
+
+        for (node_t v : {edgeNums[i], edgeNums[i + 1]})
+        {
+            if (v >= hasEdge.size())
+            {
+                hasEdge.resize(v + std::size_t{1});
+            }
+
+            totalNodes += !hasEdge[v];
+            hasEdge[v] = true;
+        }
+    }
+}
+
+solve_task::~solve_task() = default;
+
+task_status solve_task::step(std::size_t maxAugmentations)
+{
+    if (currentStatus != task_status::running)
+    {
+        return currentStatus;
+    }
+
+    if (cancelRequested)
+    {
+        currentStatus = task_status::cancelled;
+        return currentStatus;
+    }
+
+    if (std::chrono::steady_clock::now() >= deadline.load())
+    {
+        currentStatus = task_status::expired;
+        return currentStatus;
+    }
+
+    solve_scope scope("solve task step");
+    if (!engineRun)
+    {
+        engineRun = startMatching(edgeNums, engine);
+    }
+
+    bool finished = engineRun->step(std::max<std::size_t>(maxAugmentations, 1));
+    matchedNodes = engineRun->matched_nodes();
+    if (!finished)
+    {
+        return currentStatus;
+    }
+
+    auto mates = engineRun->mates();
+    engineRun.reset();
+    if (hamiltonian)
+    {
+        std::tie(cycleValues, subdivisionValues) = cycleFromMatching(edgeNums, mates);
+    }
 
+    matchingValues = graphToOutputValues(matesToGraph(mates));
+    currentStatus = task_status::done;
+    return currentStatus;
+}
+
+task_status solve_task::run_to_end(std::size_t maxAugmentations)
+{
+    while (step(maxAugmentations) == task_status::running)
+    {
+    }
+
+    return currentStatus;
+}
+
+void solve_task::cancel()
+{
+    cancelRequested = true;
+}
+
+void solve_task::set_deadline(std::chrono::steady_clock::time_point time)
+{
+    deadline = time;
+}
+
+task_status solve_task::status() const
+{
+    return currentStatus;
+}
+
+std::size_t solve_task::matched_nodes() const
+{
+    return matchedNodes;
+}
+
+std::size_t solve_task::total_nodes() const
+{
+    return totalNodes;
+}
+
+const std::vector<node_t>& solve_task::matching() const
+{
+    return matchingValues;
+}
+
+const std::vector<node_t>& solve_task::cycle() const
+{
+    return cycleValues;
+}
+
+const std::vector<node_t>& solve_task::subdivisions() const
+{
+    return subdivisionValues;
+}
+
+std::vector<node_t> solveDualGraph(std::span<const node_t> triangles)
+{
+    assert(triangles.size() % 3 == 0);
+    phase_timer timer("dual");
+    return dualEdges(triangles);
+}
+
+std::vector<node_t> dualGraph(std::span<const node_t> triangles)
+{
+    solve_scope scope("dualGraph");
+    return solveDualGraph(triangles);
+}
+
+std::vector<node_t> blossomFromTriangles(std::span<const node_t> triangles, matching_engine engine)
+{
+    solve_scope scope("blossomFromTriangles");
+    return graphToOutputValues(findMatching(solveDualGraph(triangles), engine));
+}
+
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycleFromTriangles(std::span<const node_t> triangles,
+        matching_engine engine)
+{
+    solve_scope scope("hamiltonianCycleFromTriangles");
+    auto ret = solveHamiltonianCycle(solveDualGraph(triangles), engine);
+    numberTwinsFrom(triangles.size() / 3, ret.first, ret.second);
+    return ret;
+}
+
+triangle_strip triangleStripFromTriangles(std::span<const node_t> triangles, matching_engine engine)
+{
+    solve_scope scope("triangleStripFromTriangles");
+    return solveTriangleStrip(triangles, solveDualGraph(triangles), engine);
+}
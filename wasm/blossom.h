@@ -0,0 +1,232 @@
+#ifndef BLOSSOM_H
+#define BLOSSOM_H
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+using node_t = std::uint32_t;
+
+enum class matching_engine
+{
+    contraction,
+    edmonds,
+    phased,
+    // concurrent searches with vertex claiming, sequential where threads are unavailable
+    parallel
+};
+
+// wall time of one solver phase summed over its calls; time spent in a phase
+// nested in another is counted by both
+struct phase_stats
+{
+    std::string name;
+    std::size_t calls = 0;
+    double milliseconds = 0;
+};
+
+// counters for the most recent solver call on this thread
+struct solve_stats
+{
+    std::size_t greedyMatches = 0;
+    std::size_t augmentations = 0;
+    std::size_t contractions = 0;
+    // degree 1 and 2 reductions before the engine ran and the nodes left for it, all
+    // zero when the input had nothing to reduce
+    std::size_t pendantMatches = 0;
+    std::size_t folds = 0;
+    std::size_t kernelNodes = 0;
+    // blossoms nested in blossoms, 1 for a blossom of plain vertices
+    std::size_t maxBlossomDepth = 0;
+    // largest search queue of the matching engine, and most nodes on one cycle of the
+    // cover before merging
+    std::size_t searchQueuePeak = 0;
+    std::size_t cycleQueuePeak = 0;
+    // zero unless operator new reports to countAllocation(), see stats.h
+    std::size_t allocations = 0;
+    std::size_t allocatedBytes = 0;
+    double totalMilliseconds = 0;
+    bool cubic = false;
+    // size of the node ids the engine ran with, 2 for inputs under 65535 nodes
+    std::size_t nodeBytes = 0;
+    // partitioned solves only: patches matched, and nodes of the boundary repair, the
+    // solve the engine counters above describe
+    std::size_t patches = 0;
+    std::size_t boundaryNodes = 0;
+    // in the order the phases first ran
+    std::vector<phase_stats> phases;
+};
+
+const solve_stats& lastSolveStats();
+
+// records every phase of the following solves on this thread, discarding earlier events
+void setTracing(bool enabled);
+
+// worker threads of the parallel engine and of the patch solves in blossomPartitioned()
+// for the following solves on this thread, 0 (the default) for one per core; a
+// solve_task uses the setting of the thread that steps it. Builds without
+// BLOSSOM_THREADS solve on the calling thread whatever the setting. In the browser,
+// asking for more threads than the pthread pool holds blocks the main thread.
+void setSolverThreads(std::size_t threads);
+
+// the recorded events in Chrome's trace event format, for chrome://tracing or Perfetto
+std::string traceJson();
+
+// dual nodes in the order the hamiltonian cycle visits them, twins added by
+// subdivisions are numbered after the input nodes and listed as in hamiltonianCycle();
+// nodes the cycle misses, like faces of an open mesh, follow at the end
+struct cycle_order
+{
+    std::vector<node_t> order;
+    std::vector<node_t> subdivisions;
+};
+
+// a single strip over the faces in cycle order; every subdivision adds a vertex,
+// numbered after the input vertices, in the middle of the edge given by the next
+// pair in midpoints
+struct triangle_strip
+{
+    std::vector<node_t> indices;
+    std::vector<node_t> midpoints;
+};
+
+// edge arrays hold endpoint pairs back to back, same layout as the JS bindings
+std::vector<node_t> blossom(std::span<const node_t> edgeData, matching_engine engine = matching_engine::edmonds);
+
+// the cycle as endpoint pairs, and for every merge of two cycles of the cover the
+// four nodes (v1, twin of v1, v2, twin of v2) it added across the matched edge v1 v2
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycle(std::span<const node_t> edgeData,
+        matching_engine engine = matching_engine::edmonds);
+cycle_order hamiltonianOrder(std::span<const node_t> edgeData, matching_engine engine = matching_engine::edmonds);
+
+// hamiltonianCycle() from a maximum matching of the graph already at hand, as
+// endpoint pairs like blossom() returns it
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycleFromMatching(std::span<const node_t> edgeData,
+        std::span<const node_t> matching);
+
+// weights holds one entry per edge pair; the matching is the lightest of the maximum
+// matchings, so merging the cycle cover can be steered away from costly edges.
+// O(n^3) worst case, edges of the lightest weight are matched greedily up front
+std::vector<node_t> blossomWeighted(std::span<const node_t> edgeData, std::span<const std::int64_t> weights);
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycleWeighted(std::span<const node_t> edgeData,
+        std::span<const std::int64_t> weights);
+
+enum class task_status
+{
+    running,
+    done,
+    cancelled,
+    // the deadline passed before the solve finished
+    expired
+};
+
+class matching_run;
+
+// blossom() or hamiltonianCycle() in steps of a bounded number of augmentations, so
+// the caller can report progress in between or give up on a solve that is no longer
+// wanted. The task has no thread of its own: steps run on the calling thread, which
+// may be a worker the caller started. The input is copied; it is reduced and laid
+// out by the first step and the cycle cover is built by the last, both in one go,
+// and the parallel engine always finishes in a single step. Cancel and deadline only
+// take effect between steps, so none of these is cut short. Stats are those of the
+// latest step.
+class solve_task
+{
+    const std::vector<node_t> edgeNums;
+    const bool hamiltonian;
+    const matching_engine engine;
+    std::unique_ptr<matching_run> engineRun;
+    std::vector<node_t> matchingValues;
+    std::vector<node_t> cycleValues;
+    std::vector<node_t> subdivisionValues;
+    std::size_t totalNodes;
+    std::atomic<task_status> currentStatus;
+    std::atomic<bool> cancelRequested;
+    std::atomic<std::chrono::steady_clock::time_point> deadline;
+    std::atomic<std::size_t> matchedNodes;
+
+    public:
+        solve_task(std::span<const node_t> edgeData, bool hamiltonian,
+            matching_engine engine = matching_engine::edmonds);
+        ~solve_task();
+
+        solve_task(const solve_task&) = delete;
+        solve_task& operator=(const solve_task&) = delete;
+
+        // at most maxAugmentations augmentations, 0 counts as 1; does nothing once
+        // the task has stopped
+        task_status step(std::size_t maxAugmentations);
+
+        // steps on the calling thread until the task stops; cancel() from another
+        // thread takes effect when the current step returns
+        task_status run_to_end(std::size_t maxAugmentations = 256);
+
+        // cancel(), set_deadline() and the progress accessors may be called from any
+        // thread; both stops are checked before every step, never during one
+        void cancel();
+        void set_deadline(std::chrono::steady_clock::time_point time);
+        task_status status() const;
+
+        // nodes matched so far out of the nodes with an edge, the bound on the
+        // matching's final size
+        std::size_t matched_nodes() const;
+        std::size_t total_nodes() const;
+
+        // the results as blossom() and hamiltonianCycle() return them, empty until
+        // the task is done; the cycle is only built for hamiltonian tasks
+        const std::vector<node_t>& matching() const;
+        const std::vector<node_t>& cycle() const;
+        const std::vector<node_t>& subdivisions() const;
+};
+
+// Matching in patches for inputs too large to solve as one graph. Patches are ranges
+// of patchNodes consecutive node ids, which for scanned and generated meshes are
+// spatially coherent faces, so cutting them takes a pass over the edges rather than
+// a graph of the whole input. Every patch is solved on its own, on all cores with
+// BLOSSOM_THREADS, and then the nodes within repairHops of a cut edge are solved
+// again from that matching to augment across the cut. Nodes left free after that
+// are searched from on the whole graph when exact is set, without it the matching
+// may fall short of maximum.
+struct partition_options
+{
+    // up to 65534 keeps every patch in 16 bit ids
+    std::size_t patchNodes = 65534;
+    std::size_t repairHops = 8;
+    bool exact = true;
+};
+
+std::vector<node_t> blossomPartitioned(std::span<const node_t> edgeData, const partition_options& options = {},
+        matching_engine engine = matching_engine::edmonds);
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCyclePartitioned(std::span<const node_t> edgeData,
+        const partition_options& options = {}, matching_engine engine = matching_engine::edmonds);
+
+// triangles holds 3 vertex indices per face, face i being node i of the dual in edgeData
+triangle_strip triangleStrip(std::span<const node_t> triangles, std::span<const node_t> edgeData,
+        matching_engine engine = matching_engine::edmonds);
+
+// face adjacency of a triangle index buffer, 3 vertex indices per face, as endpoint
+// pairs with node i being face i; only edges shared by exactly two faces count
+std::vector<node_t> dualGraph(std::span<const node_t> triangles);
+
+// hamiltonianCycle() numbers twins from one past the largest node with an edge;
+// this moves them to start at numNodes, so that callers with nodes past the last
+// edge, like faces of an open mesh without a dual edge, can tell every id below
+// numNodes to be an input node
+void numberTwinsFrom(std::size_t numNodes, std::vector<node_t>& cycle, std::vector<node_t>& subdivisions);
+
+// the above on the dual of triangles, built in the same call; twins are numbered
+// from the face count
+std::vector<node_t> blossomFromTriangles(std::span<const node_t> triangles,
+        matching_engine engine = matching_engine::edmonds);
+std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycleFromTriangles(std::span<const node_t> triangles,
+        matching_engine engine = matching_engine::edmonds);
+triangle_strip triangleStripFromTriangles(std::span<const node_t> triangles,
+        matching_engine engine = matching_engine::edmonds);
+
+#endif
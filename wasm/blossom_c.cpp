@@ -0,0 +1,162 @@
+#include "blossom_c.h"
+#include "blossom.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <limits>
+#include <new>
+#include <span>
+#include <vector>
+
+static_assert(sizeof(node_t) == sizeof(std::uint32_t), "the C API passes node ids as uint32_t");
+
+namespace
+{
+
+// the largest id stands for unmatched inside the solver
+bool validInput(const std::uint32_t* edges, std::size_t edgeCount)
+{
+    if (edges == nullptr)
+    {
+        return edgeCount == 0;
+    }
+
+    return std::none_of(edges, edges + 2 * edgeCount,
+        [](std::uint32_t v) { return v == std::numeric_limits<std::uint32_t>::max(); });
+}
+
+// twins are numbered from one past the largest node, two for each matched edge a
+// merge subdivides at most, and must stay below the id for unmatched
+bool twinsFit(const std::uint32_t* edges, std::size_t edgeCount)
+{
+    if (edgeCount == 0)
+    {
+        return true;
+    }
+
+    std::uint64_t numNodes = std::uint64_t{*std::max_element(edges, edges + 2 * edgeCount)} + 1;
+    std::uint64_t maxMerges = std::min<std::uint64_t>(edgeCount, numNodes / 2);
+    return numNodes + 2 * maxMerges <= std::numeric_limits<std::uint32_t>::max();
+}
+
+bool validEngine(blossom_engine engine)
+{
+    return engine >= BLOSSOM_ENGINE_CONTRACTION && engine <= BLOSSOM_ENGINE_PARALLEL;
+}
+
+matching_engine toEngine(blossom_engine engine)
+{
+    switch (engine)
+    {
+        case BLOSSOM_ENGINE_CONTRACTION: return matching_engine::contraction;
+        case BLOSSOM_ENGINE_PHASED: return matching_engine::phased;
+        case BLOSSOM_ENGINE_PARALLEL: return matching_engine::parallel;
+        case BLOSSOM_ENGINE_EDMONDS: break;
+    }
+
+    return matching_engine::edmonds;
+}
+
+bool fits(const std::vector<node_t>& values, const std::uint32_t* buffer, std::size_t capacity)
+{
+    return values.empty() || (buffer != nullptr && values.size() <= capacity);
+}
+
+// exceptions must not cross the C boundary
+template<typename F>
+blossom_status guarded(F&& f)
+{
+    try
+    {
+        return f();
+    }
+    catch (const std::bad_alloc&)
+    {
+        return BLOSSOM_OUT_OF_MEMORY;
+    }
+    catch (...)
+    {
+        return BLOSSOM_INTERNAL_ERROR;
+    }
+}
+
+}
+
+extern "C"
+{
+
+int blossom_abi_version(void)
+{
+    return BLOSSOM_ABI_VERSION;
+}
+
+const char* blossom_status_string(blossom_status status)
+{
+    switch (status)
+    {
+        case BLOSSOM_OK: return "ok";
+        case BLOSSOM_INVALID_ARGUMENT: return "invalid argument";
+        case BLOSSOM_BUFFER_TOO_SMALL: return "output buffer too small";
+        case BLOSSOM_OUT_OF_MEMORY: return "out of memory";
+        case BLOSSOM_INTERNAL_ERROR: return "internal error";
+    }
+
+    return "unknown status";
+}
+
+void blossom_set_threads(size_t threads)
+{
+    setSolverThreads(threads);
+}
+
+blossom_status blossom_matching(const uint32_t* edges, size_t edge_count, blossom_engine engine,
+    uint32_t* matching, size_t matching_capacity, size_t* matching_size)
+{
+    if (!validInput(edges, edge_count) || !validEngine(engine) || matching_size == nullptr)
+    {
+        return BLOSSOM_INVALID_ARGUMENT;
+    }
+
+    return guarded([&]()
+    {
+        auto result = blossom(std::span<const node_t>(edges, 2 * edge_count), toEngine(engine));
+        *matching_size = result.size();
+        if (!fits(result, matching, matching_capacity))
+        {
+            return BLOSSOM_BUFFER_TOO_SMALL;
+        }
+
+        std::copy(result.cbegin(), result.cend(), matching);
+        return BLOSSOM_OK;
+    });
+}
+
+blossom_status blossom_hamiltonian_cycle(const uint32_t* edges, size_t edge_count, blossom_engine engine,
+    uint32_t* cycle, size_t cycle_capacity, size_t* cycle_size,
+    uint32_t* subdivisions, size_t subdivisions_capacity, size_t* subdivisions_size)
+{
+    if (!validInput(edges, edge_count) || !twinsFit(edges, edge_count) || !validEngine(engine) || cycle_size == nullptr
+        || subdivisions_size == nullptr)
+    {
+        return BLOSSOM_INVALID_ARGUMENT;
+    }
+
+    return guarded([&]()
+    {
+        auto [cycleEdges, twins] = hamiltonianCycle(std::span<const node_t>(edges, 2 * edge_count), toEngine(engine));
+        *cycle_size = cycleEdges.size();
+        *subdivisions_size = twins.size();
+        if (!fits(cycleEdges, cycle, cycle_capacity) || !fits(twins, subdivisions, subdivisions_capacity))
+        {
+            return BLOSSOM_BUFFER_TOO_SMALL;
+        }
+
+        std::copy(cycleEdges.cbegin(), cycleEdges.cend(), cycle);
+        std::copy(twins.cbegin(), twins.cend(), subdivisions);
+        return BLOSSOM_OK;
+    });
+}
+
+}
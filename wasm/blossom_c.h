@@ -0,0 +1,79 @@
+#ifndef BLOSSOM_C_H
+#define BLOSSOM_C_H
+
+// C interface of libblossom for programs that cannot use the C++ API in blossom.h.
+// Every call works on buffers owned by the caller: edges holds endpoint pairs back to
+// back (edge_count pairs, 2 * edge_count values) and results are written to the
+// output buffers given with their capacity in values. When a buffer is too small
+// nothing is written to it, BLOSSOM_BUFFER_TOO_SMALL is returned and the *_size
+// outputs hold the capacity needed. Calls are thread safe, solver statistics are
+// kept per thread.
+
+#include <stddef.h>
+#include <stdint.h>
+
+#if defined(_WIN32) && defined(BLOSSOM_SHARED)
+    #ifdef BLOSSOM_BUILDING
+        #define BLOSSOM_API __declspec(dllexport)
+    #else
+        #define BLOSSOM_API __declspec(dllimport)
+    #endif
+#elif defined(__GNUC__)
+    #define BLOSSOM_API __attribute__((visibility("default")))
+#else
+    #define BLOSSOM_API
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// bumped whenever a declaration in this header changes incompatibly
+#define BLOSSOM_ABI_VERSION 1
+
+typedef enum blossom_engine
+{
+    BLOSSOM_ENGINE_CONTRACTION = 0,
+    BLOSSOM_ENGINE_EDMONDS = 1,
+    BLOSSOM_ENGINE_PHASED = 2,
+    BLOSSOM_ENGINE_PARALLEL = 3
+} blossom_engine;
+
+typedef enum blossom_status
+{
+    BLOSSOM_OK = 0,
+    BLOSSOM_INVALID_ARGUMENT = 1,
+    BLOSSOM_BUFFER_TOO_SMALL = 2,
+    BLOSSOM_OUT_OF_MEMORY = 3,
+    BLOSSOM_INTERNAL_ERROR = 4
+} blossom_status;
+
+// BLOSSOM_ABI_VERSION of the library actually loaded
+BLOSSOM_API int blossom_abi_version(void);
+
+BLOSSOM_API const char* blossom_status_string(blossom_status status);
+
+// Worker threads of BLOSSOM_ENGINE_PARALLEL for the following calls on the calling
+// thread, 0 (the default) for one per core. A library built without threads ignores it.
+BLOSSOM_API void blossom_set_threads(size_t threads);
+
+// A maximum matching as endpoint pairs. It never holds more than 2 * edge_count values,
+// so a buffer that large is always enough.
+BLOSSOM_API blossom_status blossom_matching(const uint32_t* edges, size_t edge_count, blossom_engine engine,
+    uint32_t* matching, size_t matching_capacity, size_t* matching_size);
+
+// A Hamiltonian cycle as endpoint pairs, and 4 values per merge of two cycles, laid
+// out as for hamiltonianCycle() in blossom.h. Every merge subdivides a matched edge,
+// so with n the largest node id plus one and m = min(edge_count, n / 2), cycle never
+// holds more than 2 * (edge_count + m) values and subdivisions never more than 4 * m;
+// buffers that large are always enough. Twins are numbered from n, up to n + 2 * m - 1
+// at most, and inputs where that would pass UINT32_MAX - 1 are BLOSSOM_INVALID_ARGUMENT.
+BLOSSOM_API blossom_status blossom_hamiltonian_cycle(const uint32_t* edges, size_t edge_count, blossom_engine engine,
+    uint32_t* cycle, size_t cycle_capacity, size_t* cycle_size,
+    uint32_t* subdivisions, size_t subdivisions_capacity, size_t* subdivisions_size);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
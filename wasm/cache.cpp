@@ -0,0 +1,338 @@
+#include "cache.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <optional>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <tuple>
+
+namespace
+{
+
+constexpr char entryMagic[4] = {'H', 'M', 'R', 'C'};
+constexpr std::uint32_t formatVersion = 1;
+
+// fields in file order, followed by the matching, cycle and subdivision values and
+// a checksum over them; native byte order, another one fails the version check
+struct entry_header
+{
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t key;
+    std::uint64_t numEdges;
+    std::uint64_t matchingSize;
+    std::uint64_t cycleSize;
+    std::uint64_t subdivisionsSize;
+    std::uint32_t hasCycle;
+    std::uint32_t reserved;
+};
+
+static_assert(sizeof(entry_header) == 56, "entry_header is written as is and must not have padding");
+
+struct cache_entry
+{
+    std::vector<node_t> matching;
+    bool hasCycle = false;
+    std::vector<node_t> cycle;
+    std::vector<node_t> subdivisions;
+};
+
+// the splitmix64 finalizer, a bijection that spreads every input bit over the output
+std::uint64_t mix(std::uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111eb;
+    x ^= x >> 31;
+    return x;
+}
+
+template<typename T>
+std::uint64_t hashValues(std::span<const T> values)
+{
+    std::uint64_t h = formatVersion;
+    for (const auto& v : values)
+    {
+        h = mix(h ^ v);
+    }
+
+    return mix(h ^ values.size());
+}
+
+// edges as sorted, distinct (smaller endpoint << 32 | larger endpoint) values
+std::vector<std::uint64_t> canonicalEdges(std::span<const node_t> edgeData)
+{
+    std::vector<std::uint64_t> edges;
+    edges.reserve(edgeData.size() / 2);
+    for (std::size_t i = 0; i + 1 < edgeData.size(); i += 2)
+    {
+        std::uint64_t v1 = std::min(edgeData[i], edgeData[i + 1]);
+        std::uint64_t v2 = std::max(edgeData[i], edgeData[i + 1]);
+        if (v1 != v2)
+        {
+            edges.push_back(v1 << 32 | v2);
+        }
+    }
+
+    std::sort(edges.begin(), edges.end());
+    edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+    return edges;
+}
+
+bool hasEdge(const std::vector<std::uint64_t>& edges, node_t v1, node_t v2)
+{
+    std::uint64_t key = std::uint64_t{std::min(v1, v2)} << 32 | std::max(v1, v2);
+    return std::binary_search(edges.begin(), edges.end(), key);
+}
+
+node_t largestNode(const std::vector<std::uint64_t>& edges)
+{
+    node_t ret = 0;
+    for (const auto& e : edges)
+    {
+        ret = std::max(ret, static_cast<node_t>(e));
+    }
+
+    return ret;
+}
+
+// a matching of the input, and a cycle whose edges between input nodes are input
+// edges, the others leading to twins numbered after the input nodes
+bool fitsInput(const cache_entry& entry, const std::vector<std::uint64_t>& edges)
+{
+    if (entry.matching.size() % 2 != 0 || entry.cycle.size() % 2 != 0 || entry.subdivisions.size() % 4 != 0)
+    {
+        return false;
+    }
+
+    node_t maxNode = largestNode(edges);
+    std::vector<bool> matched(edges.empty() ? 0 : maxNode + std::size_t{1});
+    for (std::size_t i = 0; i < entry.matching.size(); i += 2)
+    {
+        node_t v1 = entry.matching[i];
+        node_t v2 = entry.matching[i + 1];
+        if (!hasEdge(edges, v1, v2) || matched[v1] || matched[v2])
+        {
+            return false;
+        }
+
+        matched[v1] = matched[v2] = true;
+    }
+
+    for (std::size_t i = 0; i < entry.cycle.size(); i += 2)
+    {
+        node_t v1 = entry.cycle[i];
+        node_t v2 = entry.cycle[i + 1];
+        if (v1 <= maxNode && v2 <= maxNode && !hasEdge(edges, v1, v2))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+std::filesystem::path entryPath(const std::filesystem::path& directory, std::uint64_t key)
+{
+    std::ostringstream name;
+    name << std::hex << std::setw(16) << std::setfill('0') << key << ".hmc";
+    return directory / name.str();
+}
+
+bool readValues(std::ifstream& in, std::vector<node_t>& values, std::uint64_t size)
+{
+    values.resize(size);
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values.data()),
+        static_cast<std::streamsize>(size * sizeof(node_t))));
+}
+
+std::uint64_t payloadChecksum(const cache_entry& entry)
+{
+    return hashValues<node_t>(entry.matching) ^ mix(hashValues<node_t>(entry.cycle))
+        ^ mix(mix(hashValues<node_t>(entry.subdivisions)));
+}
+
+std::optional<cache_entry> readEntry(const std::filesystem::path& path, std::uint64_t key,
+        const std::vector<std::uint64_t>& edges)
+{
+    std::error_code error;
+    std::uintmax_t fileSize = std::filesystem::file_size(path, error);
+    std::ifstream in(path, std::ios::binary);
+    entry_header header;
+    if (error || !in || !in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        return std::nullopt;
+    }
+
+    // the sizes are checked against the file before anything is allocated for them
+    std::uint64_t numValues = header.matchingSize + header.cycleSize + header.subdivisionsSize;
+    if (!std::equal(std::begin(entryMagic), std::end(entryMagic), header.magic) || header.version != formatVersion
+        || header.key != key || header.numEdges != edges.size() || header.matchingSize > fileSize
+        || header.cycleSize > fileSize || header.subdivisionsSize > fileSize
+        || fileSize != sizeof(header) + numValues * sizeof(node_t) + sizeof(std::uint64_t))
+    {
+        return std::nullopt;
+    }
+
+    cache_entry entry;
+    entry.hasCycle = header.hasCycle != 0;
+    std::uint64_t checksum = 0;
+    if (!readValues(in, entry.matching, header.matchingSize) || !readValues(in, entry.cycle, header.cycleSize)
+        || !readValues(in, entry.subdivisions, header.subdivisionsSize)
+        || !in.read(reinterpret_cast<char*>(&checksum), sizeof(checksum))
+        || checksum != payloadChecksum(entry) || !fitsInput(entry, edges))
+    {
+        return std::nullopt;
+    }
+
+    return entry;
+}
+
+void writeValues(std::ofstream& out, const std::vector<node_t>& values)
+{
+    out.write(reinterpret_cast<const char*>(values.data()), static_cast<std::streamsize>(values.size() * sizeof(node_t)));
+}
+
+void writeEntry(const std::filesystem::path& path, std::uint64_t key, std::size_t numEdges, const cache_entry& entry)
+{
+    entry_header header{};
+    std::copy(std::begin(entryMagic), std::end(entryMagic), header.magic);
+    header.version = formatVersion;
+    header.key = key;
+    header.numEdges = numEdges;
+    header.matchingSize = entry.matching.size();
+    header.cycleSize = entry.cycle.size();
+    header.subdivisionsSize = entry.subdivisions.size();
+    header.hasCycle = entry.hasCycle;
+    std::uint64_t checksum = payloadChecksum(entry);
+
+    auto temporary = path;
+    temporary += ".";
+    temporary += std::to_string(std::random_device{}());
+    temporary += ".tmp";
+    bool written = false;
+    {
+        std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+        out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        writeValues(out, entry.matching);
+        writeValues(out, entry.cycle);
+        writeValues(out, entry.subdivisions);
+        out.write(reinterpret_cast<const char*>(&checksum), sizeof(checksum));
+        out.flush();
+        written = static_cast<bool>(out);
+    }
+
+    std::error_code error;
+    if (written)
+    {
+        std::filesystem::rename(temporary, path, error);
+    }
+
+    if (!written || error)
+    {
+        std::filesystem::remove(temporary, error);
+    }
+}
+
+}
+
+result_cache::result_cache(std::filesystem::path cacheDirectory): directory(std::move(cacheDirectory)),
+    partitioning(), numHits(0), numMisses(0)
+{
+    std::filesystem::create_directories(directory);
+}
+
+void result_cache::solve_in_patches(const partition_options& options)
+{
+    partitioning = options;
+}
+
+bool result_cache::solvesExactly() const
+{
+    return !partitioning || partitioning->exact;
+}
+
+std::vector<node_t> result_cache::solve(std::span<const node_t> edgeData, matching_engine engine) const
+{
+    return partitioning ? blossomPartitioned(edgeData, *partitioning, engine) : ::blossom(edgeData, engine);
+}
+
+std::vector<node_t> result_cache::blossom(std::span<const node_t> edgeData, matching_engine engine)
+{
+    auto edges = canonicalEdges(edgeData);
+    std::uint64_t key = hashValues<std::uint64_t>(edges);
+    auto path = entryPath(directory, key);
+    if (auto entry = readEntry(path, key, edges))
+    {
+        ++numHits;
+        return std::move(entry->matching);
+    }
+
+    ++numMisses;
+    cache_entry entry;
+    entry.matching = solve(edgeData, engine);
+    if (solvesExactly())
+    {
+        writeEntry(path, key, edges.size(), entry);
+    }
+
+    return std::move(entry.matching);
+}
+
+// an entry written by blossom() still saves the matching, only the cycle is built
+std::pair<std::vector<node_t>, std::vector<node_t>> result_cache::hamiltonianCycle(std::span<const node_t> edgeData,
+        matching_engine engine)
+{
+    auto edges = canonicalEdges(edgeData);
+    std::uint64_t key = hashValues<std::uint64_t>(edges);
+    auto path = entryPath(directory, key);
+    auto entry = readEntry(path, key, edges);
+    if (entry && entry->hasCycle)
+    {
+        ++numHits;
+        return {std::move(entry->cycle), std::move(entry->subdivisions)};
+    }
+
+    bool store = true;
+    if (entry)
+    {
+        ++numHits;
+    }
+    else
+    {
+        ++numMisses;
+        entry.emplace();
+        entry->matching = solve(edgeData, engine);
+        store = solvesExactly();
+    }
+
+    std::tie(entry->cycle, entry->subdivisions) = hamiltonianCycleFromMatching(edgeData, entry->matching);
+    entry->hasCycle = true;
+    if (store)
+    {
+        writeEntry(path, key, edges.size(), *entry);
+    }
+
+    return {std::move(entry->cycle), std::move(entry->subdivisions)};
+}
+
+std::size_t result_cache::hits() const
+{
+    return numHits;
+}
+
+std::size_t result_cache::misses() const
+{
+    return numMisses;
+}
+
+std::uint64_t edgeSetHash(std::span<const node_t> edgeData)
+{
+    return hashValues<std::uint64_t>(canonicalEdges(edgeData));
+}
@@ -0,0 +1,54 @@
+#ifndef CACHE_H
+#define CACHE_H
+
+#include "blossom.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <optional>
+#include <span>
+#include <utility>
+#include <vector>
+
+// blossom() and hamiltonianCycle() with their results kept on disk, one file per
+// input named after edgeSetHash(). A file holds the matching, and the cycle with its
+// subdivisions once one was asked for. Files that are truncated, corrupt, from
+// another format version or whose results do not fit the input are recomputed and
+// replaced; writes go through a temporary file and a rename, so several processes
+// can share one directory. The engine is not part of the key, any engine's result
+// is served for the same edge set. A failed write only costs the next run a solve.
+class result_cache
+{
+    std::filesystem::path directory;
+    std::optional<partition_options> partitioning;
+    std::size_t numHits;
+    std::size_t numMisses;
+
+    std::vector<node_t> solve(std::span<const node_t> edgeData, matching_engine engine) const;
+    bool solvesExactly() const;
+
+    public:
+        // the directory is created if missing
+        explicit result_cache(std::filesystem::path cacheDirectory);
+
+        // misses are solved with blossomPartitioned() from then on; without
+        // options.exact the matching may fall short of maximum, so it is returned
+        // but not written, and never served to later calls
+        void solve_in_patches(const partition_options& options);
+
+        std::vector<node_t> blossom(std::span<const node_t> edgeData,
+            matching_engine engine = matching_engine::edmonds);
+        std::pair<std::vector<node_t>, std::vector<node_t>> hamiltonianCycle(std::span<const node_t> edgeData,
+            matching_engine engine = matching_engine::edmonds);
+
+        // calls answered from disk and calls that solved, over the cache's lifetime
+        std::size_t hits() const;
+        std::size_t misses() const;
+};
+
+// hash of the input as a set of edges: the order of the edges and of their
+// endpoints, repeated edges and self loops make no difference
+std::uint64_t edgeSetHash(std::span<const node_t> edgeData);
+
+#endif
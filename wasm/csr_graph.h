@@ -0,0 +1,177 @@
+#ifndef CSR_GRAPH_H
+#define CSR_GRAPH_H
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <utility>
+#include <vector>
+
+// immutable adjacency in compressed-sparse-row form, node ids index the
+// offset array directly so they are expected to be dense (e.g. face indices)
+template<typename T = std::uint32_t>
+class csr_graph
+{
+    std::vector<std::size_t> offsets;
+    std::vector<T> adjacency;
+
+    template<typename U>
+    void build(std::span<const U> edgeNums)
+    {
+        std::size_t bound = 0;
+        for (const auto& v : edgeNums)
+        {
+            bound = std::max(bound, static_cast<std::size_t>(v) + 1);
+        }
+
+        offsets.assign(bound + 1, 0);
+        for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+        {
+            if (edgeNums[i] != edgeNums[i + 1])
+            {
+                ++offsets[edgeNums[i] + 1];
+                ++offsets[edgeNums[i + 1] + 1];
+            }
+        }
+
+        for (std::size_t v = 1; v < offsets.size(); ++v)
+        {
+            offsets[v] += offsets[v - 1];
+        }
+
+        adjacency.resize(offsets.back());
+        std::vector<std::size_t> fill(offsets.cbegin(), offsets.cend() - 1);
+        for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+        {
+            auto v1 = static_cast<T>(edgeNums[i]);
+            auto v2 = static_cast<T>(edgeNums[i + 1]);
+            if (v1 != v2)
+            {
+                adjacency[fill[v1]++] = v2;
+                adjacency[fill[v2]++] = v1;
+            }
+        }
+
+        // sort each row and drop duplicate edges, compacting in place
+        std::size_t write = 0;
+        std::size_t begin = 0;
+        for (std::size_t v = 0; v < bound; ++v)
+        {
+            std::size_t end = offsets[v + 1];
+            auto first = adjacency.begin() + begin;
+            std::sort(first, adjacency.begin() + end);
+            auto last = std::unique(first, adjacency.begin() + end);
+            offsets[v] = write;
+            write = std::move(first, last, adjacency.begin() + write) - adjacency.begin();
+            begin = end;
+        }
+
+        offsets[bound] = write;
+        adjacency.resize(write);
+        adjacency.shrink_to_fit();
+    }
+
+    public:
+        using node_type = T;
+        using edge = typename graph<T>::edge;
+
+        csr_graph(): offsets(1, 0), adjacency() {}
+
+        // edgeNums holds endpoint pairs back to back, as passed in from JS
+        explicit csr_graph(std::span<const T> edgeNums): offsets(), adjacency()
+        {
+            build(edgeNums);
+        }
+
+        // from ids of a wider type, which must all fit in T
+        template<typename U>
+        explicit csr_graph(std::span<const U> edgeNums): offsets(), adjacency()
+        {
+            build(edgeNums);
+        }
+
+        explicit csr_graph(const graph<T>& other): offsets(), adjacency()
+        {
+            std::vector<T> edgeNums;
+            edgeNums.reserve(other.num_edges() * 2);
+            for (const auto& [v1, v2] : other.edges())
+            {
+                edgeNums.push_back(v1);
+                edgeNums.push_back(v2);
+            }
+
+            build(std::span<const T>(edgeNums));
+        }
+
+        // one past the largest node id, not the number of non-isolated nodes
+        std::size_t num_nodes() const
+        {
+            return offsets.size() - 1;
+        }
+
+        std::size_t num_edges() const
+        {
+            return adjacency.size() / 2;
+        }
+
+        std::size_t degree(T v) const
+        {
+            return offsets[v + 1] - offsets[v];
+        }
+
+        bool has_node(T v) const
+        {
+            return v < num_nodes() && degree(v) != 0;
+        }
+
+        bool has_edge(T v1, T v2) const
+        {
+            if (v1 >= num_nodes())
+            {
+                return false;
+            }
+
+            auto row = edges_of_node(v1);
+            return std::binary_search(row.begin(), row.end(), v2);
+        }
+
+        std::span<const T> edges_of_node(T v) const
+        {
+            if (v >= num_nodes())
+            {
+                return {};
+            }
+
+            return std::span<const T>(adjacency.data() + offsets[v], degree(v));
+        }
+
+        std::vector<edge> edges() const
+        {
+            std::vector<edge> ret;
+            ret.reserve(num_edges());
+            for (std::size_t v = 0; v < num_nodes(); ++v)
+            {
+                for (const auto& w : edges_of_node(static_cast<T>(v)))
+                {
+                    if (v < w)
+                    {
+                        ret.emplace_back(static_cast<T>(v), w);
+                    }
+                }
+            }
+
+            return ret;
+        }
+
+        graph<T> to_graph() const
+        {
+            graph<T> ret;
+            ret.add_edges_from(*this);
+            return ret;
+        }
+};
+
+#endif
@@ -0,0 +1,138 @@
+#ifndef CUBIC_H
+#define CUBIC_H
+
+#include "csr_graph.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+// fixed degree 3 adjacency, the dual of a closed triangle mesh; neighbors of v
+// are the three entries starting at 3 * v, so no offset array is needed
+template<typename T = std::uint32_t>
+class cubic_graph
+{
+    std::vector<T> adjacency;
+
+    public:
+        using node_type = T;
+
+        cubic_graph(): adjacency() {}
+
+        explicit cubic_graph(const csr_graph<T>& other): adjacency()
+        {
+            adjacency.reserve(other.num_nodes() * 3);
+            for (std::size_t v = 0; v < other.num_nodes(); ++v)
+            {
+                auto row = other.edges_of_node(static_cast<T>(v));
+                assert(row.size() == 3);
+                adjacency.insert(adjacency.end(), row.begin(), row.end());
+            }
+        }
+
+        std::size_t num_nodes() const
+        {
+            return adjacency.size() / 3;
+        }
+
+        std::size_t num_edges() const
+        {
+            return adjacency.size() / 2;
+        }
+
+        static constexpr std::size_t degree(T)
+        {
+            return 3;
+        }
+
+        std::span<const T, 3> edges_of_node(T v) const
+        {
+            return std::span<const T, 3>(adjacency.data() + 3 * static_cast<std::size_t>(v), 3);
+        }
+
+        bool has_edge(T v1, T v2) const
+        {
+            auto row = edges_of_node(v1);
+            return row[0] == v2 || row[1] == v2 || row[2] == v2;
+        }
+};
+
+// every node has degree exactly 3 and no edge is a bridge, which by Petersen's
+// theorem guarantees a perfect matching; bridges are found with an iterative
+// Tarjan lowlink pass so long mesh strips cannot overflow the stack
+template<typename T>
+bool isBridgelessCubic(const csr_graph<T>& graph)
+{
+    constexpr T npos = std::numeric_limits<T>::max();
+    std::size_t n = graph.num_nodes();
+    if (n == 0)
+    {
+        return false;
+    }
+
+    for (std::size_t v = 0; v < n; ++v)
+    {
+        if (graph.degree(static_cast<T>(v)) != 3)
+        {
+            return false;
+        }
+    }
+
+    std::vector<T> order(n, npos);
+    std::vector<T> low(n);
+    std::vector<T> parent(n, npos);
+    std::vector<std::pair<T, std::uint8_t>> stack;
+    T counter = 0;
+    for (std::size_t start = 0; start < n; ++start)
+    {
+        if (order[start] != npos)
+        {
+            continue;
+        }
+
+        order[start] = low[start] = counter++;
+        stack.emplace_back(static_cast<T>(start), 0);
+        while (!stack.empty())
+        {
+            auto& [v, next] = stack.back();
+            if (next < 3)
+            {
+                T w = graph.edges_of_node(v)[next++];
+                if (order[w] == npos)
+                {
+                    parent[w] = v;
+                    order[w] = low[w] = counter++;
+                    stack.emplace_back(w, 0);
+                }
+                else if (w != parent[v])
+                {
+                    low[v] = std::min(low[v], order[w]);
+                }
+
+                continue;
+            }
+
+            T child = v;
+            stack.pop_back();
+            if (!stack.empty())
+            {
+                T p = stack.back().first;
+                if (low[child] > order[p])
+                {
+                    return false;
+                }
+
+                low[p] = std::min(low[p], low[child]);
+            }
+        }
+    }
+
+    return true;
+}
+
+#endif
@@ -0,0 +1,111 @@
+#ifndef DUAL_H
+#define DUAL_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+// LSD radix sort of keys below 2^keyBits, carrying values along. 11 bit digits keep
+// the histogram in L1, and every pass is a count, a prefix sum and a scatter without
+// comparisons; the sort is stable
+template<typename V>
+void radixSort(std::vector<std::uint64_t>& keys, std::vector<V>& values, unsigned keyBits)
+{
+    constexpr unsigned digitBits = 11;
+    constexpr std::uint64_t digitMask = (std::uint64_t{1} << digitBits) - 1;
+    std::vector<std::uint64_t> keyScratch(keys.size());
+    std::vector<V> valueScratch(values.size());
+    std::vector<std::size_t> offsets(digitMask + 1);
+    for (unsigned shift = 0; shift < keyBits; shift += digitBits)
+    {
+        std::fill(offsets.begin(), offsets.end(), 0);
+        for (const auto& key : keys)
+        {
+            ++offsets[(key >> shift) & digitMask];
+        }
+
+        std::size_t sum = 0;
+        for (auto& offset : offsets)
+        {
+            std::size_t count = offset;
+            offset = sum;
+            sum += count;
+        }
+
+        for (std::size_t i = 0; i < keys.size(); ++i)
+        {
+            std::size_t to = offsets[(keys[i] >> shift) & digitMask]++;
+            keyScratch[to] = keys[i];
+            valueScratch[to] = values[i];
+        }
+
+        keys.swap(keyScratch);
+        values.swap(valueScratch);
+    }
+}
+
+// Face adjacency of a triangle index buffer as endpoint pairs, node i being triangle
+// i; only manifold edges, shared by exactly two faces, give a dual edge. Mesh edges
+// are keyed by their endpoints packed into as many bits as the largest vertex needs,
+// so the radix sort makes as few passes as the vertex count allows, and it leaves
+// the faces of an edge next to each other in face order.
+template<typename T>
+std::vector<T> dualEdges(std::span<const T> triangles)
+{
+    T maxVertex = 0;
+    for (const auto& v : triangles)
+    {
+        maxVertex = std::max(maxVertex, v);
+    }
+
+    unsigned vertexBits = 0;
+    while (vertexBits < 64 && (std::uint64_t{maxVertex} >> vertexBits) != 0)
+    {
+        ++vertexBits;
+    }
+
+    std::vector<std::uint64_t> keys;
+    std::vector<T> faces;
+    keys.reserve(triangles.size());
+    faces.reserve(triangles.size());
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3)
+    {
+        auto face = static_cast<T>(i / 3);
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            std::uint64_t a = triangles[i + k];
+            std::uint64_t b = triangles[i + (k + 1) % 3];
+            if (a != b)
+            {
+                keys.push_back(std::min(a, b) << vertexBits | std::max(a, b));
+                faces.push_back(face);
+            }
+        }
+    }
+
+    radixSort(keys, faces, 2 * vertexBits);
+    std::vector<T> edgeNums;
+    edgeNums.reserve(keys.size());
+    for (std::size_t i = 0; i < keys.size();)
+    {
+        std::size_t j = i + 1;
+        while (j < keys.size() && keys[j] == keys[i])
+        {
+            ++j;
+        }
+
+        if (j - i == 2 && faces[i] != faces[i + 1])
+        {
+            edgeNums.push_back(faces[i]);
+            edgeNums.push_back(faces[i + 1]);
+        }
+
+        i = j;
+    }
+
+    return edgeNums;
+}
+
+#endif
@@ -0,0 +1,429 @@
+#ifndef EDMONDS_H
+#define EDMONDS_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// Edmonds' maximum cardinality matching without materialised contractions.
+// Blossoms are kept implicitly: every vertex belongs to a union-find set whose
+// representative is the base of its outermost blossom, and pred pointers set
+// while shrinking let augmentFrom() walk the lifted path directly.
+template<typename Graph>
+class edmonds
+{
+    public:
+        using node_type = typename Graph::node_type;
+        static constexpr node_type npos = std::numeric_limits<node_type>::max();
+
+    private:
+        enum : std::uint8_t { unlabeled, even, odd };
+
+        const Graph& graph;
+        std::vector<node_type> mate;
+        std::vector<node_type> pred;
+        std::vector<node_type> blossomParent;
+        std::vector<node_type> rootOf;
+        std::vector<std::uint8_t> dead;
+        std::vector<std::uint8_t> label;
+        std::vector<std::uint32_t> visited;
+        // nesting depth of the blossom based at a vertex, 0 for a plain vertex
+        std::vector<std::uint32_t> depth;
+        std::uint32_t stamp;
+        std::vector<node_type> queue;
+        std::vector<node_type> touched;
+        std::vector<node_type> merged;
+        std::vector<node_type>* flipLog;
+        std::size_t contractions;
+        std::size_t maxDepth;
+        std::size_t queuePeak;
+
+        node_type base(node_type v)
+        {
+            node_type root = v;
+            while (blossomParent[root] != root)
+            {
+                root = blossomParent[root];
+            }
+
+            while (blossomParent[v] != root)
+            {
+                node_type next = blossomParent[v];
+                blossomParent[v] = root;
+                v = next;
+            }
+
+            return root;
+        }
+
+        void touch(node_type v)
+        {
+            if (label[v] == unlabeled)
+            {
+                touched.push_back(v);
+            }
+        }
+
+        void reset()
+        {
+            for (const auto& v : touched)
+            {
+                label[v] = unlabeled;
+                pred[v] = npos;
+                blossomParent[v] = v;
+                rootOf[v] = npos;
+                dead[v] = 0;
+                depth[v] = 0;
+            }
+
+            queuePeak = std::max(queuePeak, queue.size());
+            touched.clear();
+            queue.clear();
+        }
+
+        node_type lca(node_type a, node_type b)
+        {
+            if (++stamp == 0)
+            {
+                std::fill(visited.begin(), visited.end(), 0);
+                stamp = 1;
+            }
+
+            while (true)
+            {
+                if (a != npos)
+                {
+                    if (visited[a] == stamp)
+                    {
+                        return a;
+                    }
+
+                    visited[a] = stamp;
+                    a = mate[a] == npos ? npos : base(pred[mate[a]]);
+                }
+
+                std::swap(a, b);
+            }
+        }
+
+        void shrink(node_type v, node_type w, node_type b)
+        {
+            while (base(v) != b)
+            {
+                pred[v] = w;
+                w = mate[v];
+                if (label[w] == odd)
+                {
+                    label[w] = even;
+                    queue.push_back(w);
+                }
+
+                merged.push_back(base(v));
+                merged.push_back(base(w));
+                v = pred[w];
+            }
+        }
+
+        // sets are only merged once both halves are walked, otherwise the
+        // second walk would see its sub-blossom bases as already part of b
+        void contract(node_type v, node_type w)
+        {
+            ++contractions;
+            node_type b = lca(base(v), base(w));
+            shrink(v, w, b);
+            shrink(w, v, b);
+            std::uint32_t nested = depth[b];
+            for (const auto& x : merged)
+            {
+                nested = std::max(nested, depth[x]);
+                blossomParent[x] = b;
+            }
+
+            depth[b] = nested + 1;
+            maxDepth = std::max<std::size_t>(maxDepth, depth[b]);
+
+            merged.clear();
+        }
+
+        // match v with w and flip the alternating path from v back to its root
+        void augmentFrom(node_type v, node_type w)
+        {
+            node_type x = mate[v];
+            mate[v] = w;
+            if (flipLog != nullptr)
+            {
+                flipLog->push_back(v);
+                flipLog->push_back(w);
+            }
+
+            while (x != npos)
+            {
+                node_type pv = pred[x];
+                node_type next = mate[pv];
+                mate[x] = pv;
+                mate[pv] = x;
+                if (flipLog != nullptr)
+                {
+                    flipLog->push_back(x);
+                    flipLog->push_back(pv);
+                }
+
+                x = next;
+            }
+        }
+
+    public:
+        explicit edmonds(const Graph& g): graph(g), mate(g.num_nodes(), npos), pred(g.num_nodes(), npos),
+            blossomParent(g.num_nodes()), rootOf(g.num_nodes(), npos), dead(g.num_nodes(), 0),
+            label(g.num_nodes(), unlabeled), visited(g.num_nodes(), 0), depth(g.num_nodes(), 0), stamp(0), queue(),
+            touched(), merged(), flipLog(nullptr), contractions(0), maxDepth(0), queuePeak(0)
+        {
+            for (std::size_t v = 0; v < blossomParent.size(); ++v)
+            {
+                blossomParent[v] = static_cast<node_type>(v);
+            }
+        }
+
+        // warm start from an existing (e.g. greedy) matching given as a mate array
+        edmonds(const Graph& g, std::vector<node_type> initialMates): edmonds(g)
+        {
+            if (initialMates.size() == mate.size())
+            {
+                mate = std::move(initialMates);
+            }
+        }
+
+        edmonds(const edmonds&) = delete;
+        edmonds& operator=(const edmonds&) = delete;
+
+        // grow to a new node id bound after nodes were added to the graph
+        void resize(std::size_t n)
+        {
+            reset();
+            std::size_t old = mate.size();
+            if (n <= old)
+            {
+                return;
+            }
+
+            mate.resize(n, npos);
+            pred.resize(n, npos);
+            blossomParent.resize(n);
+            rootOf.resize(n, npos);
+            dead.resize(n, 0);
+            label.resize(n, unlabeled);
+            visited.resize(n, 0);
+            depth.resize(n, 0);
+            for (std::size_t v = old; v < n; ++v)
+            {
+                blossomParent[v] = static_cast<node_type>(v);
+            }
+        }
+
+        // drop the matched edge at v, e.g. because the graph lost it
+        void unmatch(node_type v)
+        {
+            if (mate[v] != npos)
+            {
+                mate[mate[v]] = npos;
+                mate[v] = npos;
+            }
+        }
+
+        // every vertex whose mate changes in later augmentations is appended to log
+        void log_flips(std::vector<node_type>* log)
+        {
+            flipLog = log;
+        }
+
+        // grow an alternating tree from a free root, augmenting if it reaches another free vertex
+        bool search(node_type root)
+        {
+            reset();
+            touch(root);
+            label[root] = even;
+            queue.push_back(root);
+            for (std::size_t head = 0; head < queue.size(); ++head)
+            {
+                node_type v = queue[head];
+                for (const auto& w : graph.edges_of_node(v))
+                {
+                    if (label[w] == odd || base(v) == base(w))
+                    {
+                        continue;
+                    }
+
+                    if (label[w] == unlabeled)
+                    {
+                        touch(w);
+                        pred[w] = v;
+                        if (mate[w] == npos)
+                        {
+                            augmentFrom(v, w);
+                            mate[w] = v;
+                            return true;
+                        }
+
+                        label[w] = odd;
+                        node_type x = mate[w];
+                        touch(x);
+                        label[x] = even;
+                        queue.push_back(x);
+                    }
+                    else
+                    {
+                        contract(v, w);
+                    }
+                }
+            }
+
+            return false;
+        }
+
+        // grow trees from every free vertex at once; when two trees meet, augment and
+        // freeze both so the rest of the forest keeps searching for disjoint paths
+        std::size_t phase()
+        {
+            reset();
+            for (std::size_t v = 0; v < mate.size(); ++v)
+            {
+                node_type root = static_cast<node_type>(v);
+                if (mate[root] == npos && graph.degree(root) != 0)
+                {
+                    touch(root);
+                    label[root] = even;
+                    rootOf[root] = root;
+                    queue.push_back(root);
+                }
+            }
+
+            std::size_t augmentations = 0;
+            for (std::size_t head = 0; head < queue.size(); ++head)
+            {
+                node_type v = queue[head];
+                for (const auto& w : graph.edges_of_node(v))
+                {
+                    if (dead[rootOf[v]])
+                    {
+                        break;
+                    }
+
+                    if (label[w] == odd || (label[w] == even && dead[rootOf[w]]) || base(v) == base(w))
+                    {
+                        continue;
+                    }
+
+                    if (label[w] == unlabeled)
+                    {
+                        touch(w);
+                        pred[w] = v;
+                        rootOf[w] = rootOf[v];
+                        if (mate[w] == npos)
+                        {
+                            augmentFrom(v, w);
+                            mate[w] = v;
+                            dead[rootOf[v]] = 1;
+                            ++augmentations;
+                            continue;
+                        }
+
+                        label[w] = odd;
+                        node_type x = mate[w];
+                        touch(x);
+                        label[x] = even;
+                        rootOf[x] = rootOf[v];
+                        queue.push_back(x);
+                    }
+                    else if (rootOf[v] != rootOf[w])
+                    {
+                        augmentFrom(v, w);
+                        augmentFrom(w, v);
+                        dead[rootOf[v]] = 1;
+                        dead[rootOf[w]] = 1;
+                        ++augmentations;
+                    }
+                    else
+                    {
+                        contract(v, w);
+                    }
+                }
+            }
+
+            reset();
+            return augmentations;
+        }
+
+        // repeat phases until one finds nothing, at which point the matching is maximum
+        std::size_t run_phases()
+        {
+            std::size_t augmentations = 0;
+            while (std::size_t found = phase())
+            {
+                augmentations += found;
+            }
+
+            return augmentations;
+        }
+
+        // a root that fails once can never be augmented later, so one pass suffices
+        std::size_t run()
+        {
+            std::size_t cursor = 0;
+            return run_slice(cursor, std::numeric_limits<std::size_t>::max());
+        }
+
+        // run() in slices: searches from the roots from cursor on and stops after
+        // budget augmentations, the matching is maximum once cursor reaches mates().size()
+        std::size_t run_slice(std::size_t& cursor, std::size_t budget)
+        {
+            std::size_t augmentations = 0;
+            for (; cursor < mate.size() && augmentations < budget; ++cursor)
+            {
+                node_type root = static_cast<node_type>(cursor);
+                if (mate[root] == npos && graph.degree(root) != 0 && search(root))
+                {
+                    ++augmentations;
+                }
+            }
+
+            reset();
+            return augmentations;
+        }
+
+        std::size_t num_contractions() const
+        {
+            return contractions;
+        }
+
+        std::size_t max_depth() const
+        {
+            return maxDepth;
+        }
+
+        // the longest the search queue has been, one tree in search() or the whole forest in phase()
+        std::size_t queue_peak() const
+        {
+            return std::max(queuePeak, queue.size());
+        }
+
+        const std::vector<node_type>& mates() const
+        {
+            return mate;
+        }
+
+        std::size_t size() const
+        {
+            std::size_t ret = 0;
+            for (std::size_t v = 0; v < mate.size(); ++v)
+            {
+                ret += mate[v] != npos && v < mate[v];
+            }
+
+            return ret;
+        }
+};
+
+#endif
@@ -1,84 +1,150 @@
 #ifndef FOREST_H
 #define FOREST_H
 
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
+#include <limits>
+#include <type_traits>
 #include <unordered_map>
-#include <unordered_set>
 #include <vector>
 
 template<typename T>
 class forest
 {
-    std::vector<std::size_t> parents;
-    std::unordered_map<T, std::size_t> lookup;
-    std::unordered_map<std::size_t, T> reverseLookup;
+    static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+    // integer nodes (the only kind the solver uses) are looked up by direct indexing
+    using lookup_t = std::conditional_t<std::is_integral_v<T>,
+        std::vector<std::size_t>, std::unordered_map<T, std::size_t>>;
 
-    std::size_t rootInternal(std::size_t node) const
+    std::vector<std::size_t> parents;
+    lookup_t lookup;
+    std::vector<T> reverseLookup;
+
+    // union-find over tree membership; offsets hold depth relative to the set parent,
+    // or absolute depth at a representative, so re-rooting a whole tree is one union
+    mutable std::vector<std::size_t> sets;
+    mutable std::vector<std::ptrdiff_t> offsets;
+    std::vector<std::uint8_t> ranks;
+    std::vector<std::size_t> treeRoots;
+    std::size_t numTrees;
+
+    std::size_t find(const T& v) const
     {
-        while (parents[node] != node)
+        if constexpr (std::is_integral_v<T>)
         {
-            node = parents[node];
+            auto i = static_cast<std::size_t>(v);
+            return i < lookup.size() ? lookup[i] : npos;
         }
+        else
+        {
+            auto nodePtr = lookup.find(v);
+            return nodePtr != lookup.end() ? nodePtr->second : npos;
+        }
+    }
 
+    std::size_t at(const T& v) const
+    {
+        std::size_t node = find(v);
+        assert(node != npos);
         return node;
     }
 
+    std::size_t findSet(std::size_t node) const
+    {
+        std::size_t rep = node;
+        std::ptrdiff_t total = 0;
+        while (sets[rep] != rep)
+        {
+            total += offsets[rep];
+            rep = sets[rep];
+        }
+
+        while (node != rep)
+        {
+            std::size_t next = sets[node];
+            std::ptrdiff_t old = offsets[node];
+            offsets[node] = total;
+            sets[node] = rep;
+            total -= old;
+            node = next;
+        }
+
+        return rep;
+    }
+
+    std::size_t depth(std::size_t node) const
+    {
+        std::size_t rep = findSet(node);
+        return static_cast<std::size_t>(node == rep ? offsets[rep] : offsets[node] + offsets[rep]);
+    }
+
     std::size_t internalOrCreate(const T& start)
     {
-        if (auto nodePtr = lookup.find(start); nodePtr != lookup.end())
+        if (std::size_t node = find(start); node != npos)
         {
-            return nodePtr->second;
+            return node;
         }
 
         std::size_t nextNode = parents.size();
+        if constexpr (std::is_integral_v<T>)
+        {
+            auto i = static_cast<std::size_t>(start);
+            if (i >= lookup.size())
+            {
+                lookup.resize(i + 1, npos);
+            }
+
+            lookup[i] = nextNode;
+        }
+        else
+        {
+            lookup.emplace(start, nextNode);
+        }
+
         parents.push_back(nextNode);
-        lookup.emplace(start, nextNode);
-        reverseLookup.emplace(nextNode, start);
+        reverseLookup.push_back(start);
+        sets.push_back(nextNode);
+        offsets.push_back(0);
+        ranks.push_back(0);
+        treeRoots.push_back(nextNode);
+        ++numTrees;
         return nextNode;
     }
 
     public:
-        forest(): parents(), lookup(), reverseLookup() {}
+        forest(): parents(), lookup(), reverseLookup(), sets(), offsets(), ranks(), treeRoots(), numTrees(0) {}
 
         // concepts not in libc++ 12.0 (what emscripten uses), uncomment in 13.0
         template<typename It> //requires std::incrementable<It>
-        forest(It begin, It end): parents(), lookup(), reverseLookup()
+        forest(It begin, It end): forest()
         {
-            std::size_t index = 0;
-            for (It i = begin; i != end; ++i, ++index)
+            for (It i = begin; i != end; ++i)
             {
-                parents.push_back(index);
-                lookup.emplace(*i, index);
-                reverseLookup.emplace(index, *i);
+                internalOrCreate(*i);
             }
         }
 
         const T& root(const T& start) const
         {
-            return reverseLookup.at(rootInternal(lookup.at(start)));
+            return reverseLookup[treeRoots[findSet(at(start))]];
         }
 
         std::size_t distance(const T& start) const
         {
-            std::size_t dist = 0;
-            std::size_t node = lookup.at(start);
-            while (parents[node] != node)
-            {
-                node = parents[node];
-                ++dist;
-            }
-
-            return dist;
+            return depth(at(start));
         }
 
         std::vector<T> path(const T& start) const
         {
             std::vector<T> ret{start};
-            std::size_t node = lookup.at(start);
+            std::size_t node = at(start);
             while (parents[node] != node)
             {
                 node = parents[node];
-                ret.push_back(reverseLookup.at(node));
+                ret.push_back(reverseLookup[node]);
             }
 
             return ret;
@@ -86,44 +152,84 @@ class forest
 
         bool has(const T& v) const
         {
-            return lookup.contains(v);
+            return find(v) != npos;
         }
 
         bool same_tree(const T& v1, const T& v2) const
         {
-            return root(v1) == root(v2);
+            return findSet(at(v1)) == findSet(at(v2));
         }
 
         std::size_t num_trees() const
         {
-            std::unordered_set<std::size_t> unique;
-            for (std::size_t i = 0; i < parents.size(); ++i)
-            {
-                unique.insert(rootInternal(i));
-            }
-
-            return unique.size();
+            return numTrees;
         }
 
         void add_node(const T& node)
         {
-            if (!lookup.contains(node))
+            internalOrCreate(node);
+        }
+
+        // forget every node but keep the storage, so one forest can serve many searches
+        void clear()
+        {
+            if constexpr (std::is_integral_v<T>)
+            {
+                for (const auto& v : reverseLookup)
+                {
+                    lookup[static_cast<std::size_t>(v)] = npos;
+                }
+            }
+            else
             {
-                std::size_t nextNode = parents.size();
-                parents.push_back(nextNode);
-                lookup.emplace(node, nextNode);
-                reverseLookup.emplace(nextNode, node);
+                lookup.clear();
             }
+
+            parents.clear();
+            reverseLookup.clear();
+            sets.clear();
+            offsets.clear();
+            ranks.clear();
+            treeRoots.clear();
+            numTrees = 0;
         }
 
+        // child must be new, the root of another tree, or already attached to parent
         void set_edge(const T& parent, const T& child)
         {
             std::size_t r1 = internalOrCreate(parent);
             std::size_t r2 = internalOrCreate(child);
-            if (r1 != r2)
+            if (r1 == r2 || parents[r2] == r1)
+            {
+                return;
+            }
+
+            assert(parents[r2] == r2);
+            std::size_t set1 = findSet(r1);
+            std::size_t set2 = findSet(r2);
+            assert(set1 != set2);
+
+            parents[r2] = r1;
+            std::ptrdiff_t shift = static_cast<std::ptrdiff_t>(depth(r1)) + 1;
+            std::size_t treeRoot = treeRoots[set1];
+            if (ranks[set1] >= ranks[set2])
             {
-                parents[r2] = r1;
+                sets[set2] = set1;
+                offsets[set2] += shift - offsets[set1];
+                if (ranks[set1] == ranks[set2])
+                {
+                    ++ranks[set1];
+                }
             }
+            else
+            {
+                sets[set1] = set2;
+                offsets[set2] += shift;
+                offsets[set1] -= offsets[set2];
+                treeRoots[set2] = treeRoot;
+            }
+
+            --numTrees;
         }
 };
 
@@ -0,0 +1,1169 @@
+#include "blossom.h"
+#include "blossom_c.h"
+#include "cache.h"
+#include "generators.h"
+#include "session.h"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+// Differential test of the matching engines. Every case is a generated graph that all
+// engines and entry points solve; each matching must be one of the graph's, and all
+// must have the size of a maximum matching, proven by a Tutte-Berge certificate and on
+// small graphs also by exhaustive search, which also knows the lightest maximum
+// matching blossomWeighted() has to find. Closed mesh duals have their Hamiltonian
+// cycle checked as well, other graphs the edges of what hamiltonianCycle() makes of
+// them; the triangle strips of closed and open meshes have to hold every face. The C API, result_cache round trips and matching_session edit rounds are
+// held to the same answers. A failing case prints its seed, which --seed reproduces.
+
+namespace
+{
+
+using edge_list = std::vector<node_t>;
+
+struct test_case
+{
+    std::string family;
+    edge_list edges;
+    // the mesh when edges are its dual; a closed mesh has a cubic and bridgeless dual,
+    // so it has a perfect matching and a Hamiltonian cycle after subdivisions
+    std::vector<node_t> triangles;
+    bool closed = false;
+};
+
+// nodes with at least one edge, and their neighbors without loops or repeats
+struct adjacency
+{
+    std::vector<bool> present;
+    std::vector<std::vector<node_t>> neighbors;
+
+    // numNodes counts nodes past the last edge too, like faces without a neighbor
+    explicit adjacency(const edge_list& edges, std::size_t numNodes = 0)
+    {
+        if (!edges.empty())
+        {
+            numNodes = std::max<std::size_t>(numNodes, *std::max_element(edges.begin(), edges.end()) + std::size_t{1});
+        }
+
+        present.resize(numNodes);
+        neighbors.resize(numNodes);
+        for (std::size_t i = 0; i + 1 < edges.size(); i += 2)
+        {
+            node_t v1 = edges[i];
+            node_t v2 = edges[i + 1];
+            present[v1] = present[v2] = true;
+            if (v1 != v2)
+            {
+                neighbors[v1].push_back(v2);
+                neighbors[v2].push_back(v1);
+            }
+        }
+
+        for (auto& list : neighbors)
+        {
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+        }
+    }
+
+    std::size_t size() const
+    {
+        return present.size();
+    }
+
+    bool has_edge(node_t v1, node_t v2) const
+    {
+        return v1 < size() && v2 < size() && std::binary_search(neighbors[v1].begin(), neighbors[v1].end(), v2);
+    }
+};
+
+class check_failure: public std::runtime_error
+{
+    using std::runtime_error::runtime_error;
+};
+
+void expect(bool condition, const std::string& what)
+{
+    if (!condition)
+    {
+        throw check_failure(what);
+    }
+}
+
+// --- generators ---
+
+void addEdge(edge_list& edges, node_t v1, node_t v2)
+{
+    edges.push_back(v1);
+    edges.push_back(v2);
+}
+
+edge_list randomGraph(std::mt19937& rng, node_t numNodes, double density)
+{
+    edge_list edges;
+    std::bernoulli_distribution take(density);
+    for (node_t v1 = 0; v1 < numNodes; ++v1)
+    {
+        for (node_t v2 = v1 + 1; v2 < numNodes; ++v2)
+        {
+            if (take(rng))
+            {
+                addEdge(edges, v1, v2);
+            }
+        }
+    }
+
+    return edges;
+}
+
+// a ring of an odd number of pieces, each a ring of the same kind one level down, with
+// paths hanging off; augmenting through it means contracting blossoms inside blossoms
+std::vector<node_t> oddRings(std::mt19937& rng, edge_list& edges, node_t& nextNode, unsigned depth)
+{
+    if (depth == 0)
+    {
+        return {nextNode++};
+    }
+
+    std::uniform_int_distribution<unsigned> half(1, depth > 2 ? 1 : 2);
+    unsigned length = 2 * half(rng) + 1;
+    std::vector<std::vector<node_t>> pieces;
+    for (unsigned i = 0; i < length; ++i)
+    {
+        pieces.push_back(oddRings(rng, edges, nextNode, depth - 1));
+    }
+
+    auto pick = [&](const std::vector<node_t>& piece)
+    {
+        return piece[std::uniform_int_distribution<std::size_t>(0, piece.size() - 1)(rng)];
+    };
+
+    std::vector<node_t> nodes;
+    for (unsigned i = 0; i < length; ++i)
+    {
+        addEdge(edges, pick(pieces[i]), pick(pieces[(i + 1) % length]));
+        nodes.insert(nodes.end(), pieces[i].begin(), pieces[i].end());
+    }
+
+    std::uniform_int_distribution<unsigned> stems(0, 2);
+    for (unsigned i = stems(rng); i > 0; --i)
+    {
+        node_t from = pick(nodes);
+        for (unsigned j = std::uniform_int_distribution<unsigned>(1, 3)(rng); j > 0; --j)
+        {
+            addEdge(edges, from, nextNode);
+            from = nextNode++;
+        }
+    }
+
+    return nodes;
+}
+
+edge_list nestedOddCycles(std::mt19937& rng, unsigned depth)
+{
+    edge_list edges;
+    node_t nextNode = 0;
+    oddRings(rng, edges, nextNode, depth);
+    return edges;
+}
+
+// pieces side by side with their ids shuffled, so no piece is a range of ids, and
+// with unused ids in between
+edge_list disjointUnion(std::mt19937& rng, const std::vector<edge_list>& pieces)
+{
+    edge_list edges;
+    node_t offset = 0;
+    for (const auto& piece : pieces)
+    {
+        node_t pieceNodes = piece.empty() ? 0 : *std::max_element(piece.begin(), piece.end()) + 1;
+        for (const auto& v : piece)
+        {
+            edges.push_back(v + offset);
+        }
+
+        offset += pieceNodes + std::uniform_int_distribution<node_t>(0, 2)(rng);
+    }
+
+    std::vector<node_t> ids(offset);
+    std::iota(ids.begin(), ids.end(), 0);
+    std::shuffle(ids.begin(), ids.end(), rng);
+    for (auto& v : edges)
+    {
+        v = ids[v];
+    }
+
+    return edges;
+}
+
+// shuffled edge order and endpoint order, some edges repeated
+edge_list scrambled(std::mt19937& rng, edge_list edges)
+{
+    std::vector<std::pair<node_t, node_t>> pairs;
+    for (std::size_t i = 0; i + 1 < edges.size(); i += 2)
+    {
+        pairs.emplace_back(edges[i], edges[i + 1]);
+    }
+
+    std::bernoulli_distribution coin(0.5);
+    std::bernoulli_distribution repeat(0.05);
+    for (std::size_t i = 0, size = pairs.size(); i < size; ++i)
+    {
+        if (repeat(rng))
+        {
+            pairs.push_back(pairs[i]);
+        }
+    }
+
+    std::shuffle(pairs.begin(), pairs.end(), rng);
+    edges.clear();
+    for (auto [v1, v2] : pairs)
+    {
+        if (coin(rng))
+        {
+            std::swap(v1, v2);
+        }
+
+        addEdge(edges, v1, v2);
+    }
+
+    return edges;
+}
+
+std::vector<node_t> randomMesh(std::mt19937& rng)
+{
+    switch (std::uniform_int_distribution<int>(0, 4)(rng))
+    {
+        case 0:
+            return icosphere(std::uniform_int_distribution<unsigned>(0, 2)(rng));
+        case 1:
+            return torus(std::uniform_int_distribution<std::size_t>(3, 9)(rng),
+                std::uniform_int_distribution<std::size_t>(3, 9)(rng));
+        case 2:
+            return longStrip(std::uniform_int_distribution<std::size_t>(3, 8)(rng));
+        default:
+            return randomTriangulation(2 * std::uniform_int_distribution<std::size_t>(2, 200)(rng), rng());
+    }
+}
+
+// fans of one to eight faces, or a mesh from randomMesh() with faces cut away and the
+// rest renumbered; either way faces without a cover edge, alone or matched in pairs
+std::vector<node_t> openMesh(std::mt19937& rng)
+{
+    std::vector<node_t> triangles;
+    if (std::bernoulli_distribution(0.5)(rng))
+    {
+        for (node_t i = std::uniform_int_distribution<node_t>(1, 8)(rng); i > 0; --i)
+        {
+            triangles.insert(triangles.end(), {0, i, i + 1});
+        }
+
+        return triangles;
+    }
+
+    auto closed = randomMesh(rng);
+    std::bernoulli_distribution cut(std::uniform_real_distribution<double>(0.1, 0.6)(rng));
+    for (std::size_t i = 0; i + 2 < closed.size(); i += 3)
+    {
+        if (!cut(rng))
+        {
+            triangles.insert(triangles.end(), closed.begin() + static_cast<std::ptrdiff_t>(i),
+                closed.begin() + static_cast<std::ptrdiff_t>(i + 3));
+        }
+    }
+
+    return triangles;
+}
+
+test_case makeCase(std::mt19937& rng, std::size_t maxNodes)
+{
+    std::uniform_int_distribution<node_t> smallNodes(1, static_cast<node_t>(std::min<std::size_t>(maxNodes, 16)));
+    std::uniform_int_distribution<node_t> nodes(1, static_cast<node_t>(maxNodes));
+    std::uniform_real_distribution<double> density(0.02, 0.5);
+    test_case ret;
+    switch (std::uniform_int_distribution<int>(0, 6)(rng))
+    {
+        case 0:
+            ret.family = "small random";
+            ret.edges = randomGraph(rng, smallNodes(rng), density(rng));
+            break;
+        case 1:
+        {
+            // sparse enough to leave nodes free, which is where engines disagree
+            node_t numNodes = nodes(rng);
+            ret.family = "random";
+            ret.edges = randomGraph(rng, numNodes, std::uniform_real_distribution<double>(0.5, 3.0)(rng) / numNodes);
+            break;
+        }
+        case 2:
+            ret.family = "nested odd cycles";
+            ret.edges = nestedOddCycles(rng, std::uniform_int_distribution<unsigned>(1, 4)(rng));
+            break;
+        case 3:
+            ret.family = "cubic dual";
+            ret.triangles = randomMesh(rng);
+            ret.closed = true;
+            ret.edges = scrambled(rng, dualGraph(ret.triangles));
+            break;
+        case 4:
+            ret.family = "open mesh";
+            ret.triangles = openMesh(rng);
+            ret.edges = scrambled(rng, dualGraph(ret.triangles));
+            break;
+        case 5:
+        {
+            ret.family = "disconnected";
+            std::vector<edge_list> pieces;
+            for (int i = std::uniform_int_distribution<int>(2, 5)(rng); i > 0; --i)
+            {
+                bool odd = std::bernoulli_distribution(0.5)(rng);
+                pieces.push_back(odd ? nestedOddCycles(rng, std::uniform_int_distribution<unsigned>(1, 3)(rng))
+                    : randomGraph(rng, smallNodes(rng), density(rng)));
+            }
+
+            ret.edges = disjointUnion(rng, pieces);
+            break;
+        }
+        default:
+        {
+            // odd cliques and complete bipartite graphs with one side larger
+            node_t size = std::uniform_int_distribution<node_t>(1, 6)(rng);
+            ret.family = "dense";
+            if (std::bernoulli_distribution(0.5)(rng))
+            {
+                ret.edges = randomGraph(rng, 2 * size + 1, 1.0);
+            }
+            else
+            {
+                for (node_t v1 = 0; v1 < size; ++v1)
+                {
+                    for (node_t v2 = size; v2 < 3 * size + 1; ++v2)
+                    {
+                        addEdge(ret.edges, v1, v2);
+                    }
+                }
+            }
+
+            ret.edges = scrambled(rng, ret.edges);
+            break;
+        }
+    }
+
+    return ret;
+}
+
+// --- checks ---
+
+// mates of a matching given as endpoint pairs, after checking that its edges are edges
+// of the graph and share no endpoint
+std::vector<node_t> checkMatching(const adjacency& graph, const edge_list& matching)
+{
+    constexpr node_t unmatched = static_cast<node_t>(-1);
+    expect(matching.size() % 2 == 0, "matching has an incomplete edge");
+    std::vector<node_t> mate(graph.size(), unmatched);
+    for (std::size_t i = 0; i < matching.size(); i += 2)
+    {
+        node_t v1 = matching[i];
+        node_t v2 = matching[i + 1];
+        expect(graph.has_edge(v1, v2), "matched edge " + std::to_string(v1) + " " + std::to_string(v2)
+            + " is not in the graph");
+        expect(mate[v1] == unmatched && mate[v2] == unmatched, "node matched twice in edge "
+            + std::to_string(v1) + " " + std::to_string(v2));
+        mate[v1] = v2;
+        mate[v2] = v1;
+    }
+
+    return mate;
+}
+
+// maximum matching size by exhaustive search over node subsets
+std::size_t bruteForceMatching(const adjacency& graph)
+{
+    std::size_t numNodes = graph.size();
+    std::vector<int> best(std::size_t{1} << numNodes, -1);
+    best[0] = 0;
+    std::function<int(std::size_t)> solve = [&](std::size_t mask)
+    {
+        if (best[mask] >= 0)
+        {
+            return best[mask];
+        }
+
+        // the lowest node stays free or is matched to a neighbor in the set
+        node_t v1 = static_cast<node_t>(std::countr_zero(mask));
+        std::size_t rest = mask & (mask - 1);
+        int ret = solve(rest);
+        for (const auto& v2 : graph.neighbors[v1])
+        {
+            if (rest >> v2 & 1)
+            {
+                ret = std::max(ret, 1 + solve(rest & ~(std::size_t{1} << v2)));
+            }
+        }
+
+        return best[mask] = ret;
+    };
+
+    return static_cast<std::size_t>(solve(best.size() - 1));
+}
+
+// weight of the lightest maximum matching by the same search, lightest[v1][v2] being
+// the lightest copy of the edge
+std::int64_t bruteForceWeight(const adjacency& graph, const std::vector<std::vector<std::int64_t>>& lightest)
+{
+    // (size, -weight), so the best is the largest
+    using score = std::pair<int, std::int64_t>;
+    std::size_t numNodes = graph.size();
+    std::vector<score> best(std::size_t{1} << numNodes, score{-1, 0});
+    best[0] = score{0, 0};
+    std::function<score(std::size_t)> solve = [&](std::size_t mask)
+    {
+        if (best[mask].first >= 0)
+        {
+            return best[mask];
+        }
+
+        node_t v1 = static_cast<node_t>(std::countr_zero(mask));
+        std::size_t rest = mask & (mask - 1);
+        score ret = solve(rest);
+        for (const auto& v2 : graph.neighbors[v1])
+        {
+            if (rest >> v2 & 1)
+            {
+                score with = solve(rest & ~(std::size_t{1} << v2));
+                ret = std::max(ret, score{with.first + 1, with.second - lightest[v1][v2]});
+            }
+        }
+
+        return best[mask] = ret;
+    };
+
+    return -solve(best.size() - 1).second;
+}
+
+// Tutte-Berge: for every node set A, a matching leaves at least odd(G - A) - |A| nodes
+// free, odd() counting the components with an odd number of nodes. A matching that
+// leaves exactly that many free for some A is maximum. The Gallai-Edmonds A is the
+// set of nodes next to those some maximum matching leaves free, found here by
+// solving without each matched node; the bound itself does not depend on that
+// search being right, a wrong A just fails to meet it.
+void checkTutteBerge(const adjacency& graph, std::size_t matchingSize, const std::vector<node_t>& mate,
+        const edge_list& edges)
+{
+    std::size_t numNodes = static_cast<std::size_t>(std::count(graph.present.begin(), graph.present.end(), true));
+    std::vector<bool> missable(graph.size());
+    for (node_t v = 0; v < graph.size(); ++v)
+    {
+        if (!graph.present[v])
+        {
+            continue;
+        }
+
+        if (mate[v] == static_cast<node_t>(-1))
+        {
+            missable[v] = true;
+            continue;
+        }
+
+        edge_list without;
+        for (std::size_t i = 0; i + 1 < edges.size(); i += 2)
+        {
+            if (edges[i] != v && edges[i + 1] != v)
+            {
+                addEdge(without, edges[i], edges[i + 1]);
+            }
+        }
+
+        missable[v] = blossom(without).size() / 2 == matchingSize;
+    }
+
+    std::vector<bool> barrier(graph.size());
+    for (node_t v = 0; v < graph.size(); ++v)
+    {
+        if (missable[v])
+        {
+            for (const auto& w : graph.neighbors[v])
+            {
+                barrier[w] = !missable[w];
+            }
+        }
+    }
+
+    std::size_t barrierSize = 0;
+    std::size_t oddComponents = 0;
+    std::vector<bool> seen(graph.size());
+    for (node_t start = 0; start < graph.size(); ++start)
+    {
+        barrierSize += barrier[start];
+        if (!graph.present[start] || barrier[start] || seen[start])
+        {
+            continue;
+        }
+
+        std::size_t componentSize = 0;
+        std::vector<node_t> stack{start};
+        seen[start] = true;
+        while (!stack.empty())
+        {
+            node_t v = stack.back();
+            stack.pop_back();
+            ++componentSize;
+            for (const auto& w : graph.neighbors[v])
+            {
+                if (!barrier[w] && !seen[w])
+                {
+                    seen[w] = true;
+                    stack.push_back(w);
+                }
+            }
+        }
+
+        oddComponents += componentSize % 2;
+    }
+
+    std::size_t bound = (numNodes + barrierSize - oddComponents) / 2;
+    expect(matchingSize == bound, "matching of size " + std::to_string(matchingSize) + " is not maximum by "
+        + "Tutte-Berge, bound " + std::to_string(bound) + " from a barrier of " + std::to_string(barrierSize)
+        + " nodes and " + std::to_string(oddComponents) + " odd components");
+}
+
+// the cycle is one cycle through every input node and every twin the subdivisions
+// name, and any of its edges between two input nodes is an input edge; graphs that
+// are not cubic only get the edges and twins checked, there need not be a cycle
+void checkCycle(const adjacency& graph, const edge_list& cycle, const edge_list& subdivisions, bool cubic)
+{
+    expect(cycle.size() % 2 == 0, "cycle has an incomplete edge");
+    expect(subdivisions.size() % 4 == 0, "subdivisions are not groups of four");
+    std::size_t numNodes = graph.size() + subdivisions.size() / 2;
+    std::vector<std::vector<node_t>> neighbors(numNodes);
+    for (std::size_t i = 0; i < cycle.size(); i += 2)
+    {
+        node_t v1 = cycle[i];
+        node_t v2 = cycle[i + 1];
+        expect(v1 < numNodes && v2 < numNodes, "cycle node out of range");
+        expect(v1 >= graph.size() || v2 >= graph.size() || graph.has_edge(v1, v2), "cycle edge "
+            + std::to_string(v1) + " " + std::to_string(v2) + " is not in the graph");
+        neighbors[v1].push_back(v2);
+        neighbors[v2].push_back(v1);
+    }
+
+    for (std::size_t i = 0; i < subdivisions.size(); i += 2)
+    {
+        expect(subdivisions[i + 1] >= graph.size(), "subdivision twin is an input node");
+    }
+
+    for (node_t v = cubic ? 0 : static_cast<node_t>(graph.size()); v < numNodes; ++v)
+    {
+        expect(neighbors[v].size() == 2, "cycle node " + std::to_string(v) + " has "
+            + std::to_string(neighbors[v].size()) + " cycle edges");
+    }
+
+    if (!cubic || numNodes == 0)
+    {
+        return;
+    }
+
+    node_t previous = 0;
+    node_t current = neighbors[0][0];
+    std::size_t length = 1;
+    while (current != 0)
+    {
+        node_t next = neighbors[current][0] == previous ? neighbors[current][1] : neighbors[current][0];
+        previous = current;
+        current = next;
+        ++length;
+        expect(length <= numNodes, "cycle does not close");
+    }
+
+    expect(length == numNodes, "cycle cover has more than one cycle, the first visits " + std::to_string(length)
+        + " of " + std::to_string(numNodes) + " nodes");
+}
+
+// --- the engines under test ---
+
+struct solver
+{
+    std::string name;
+    std::function<edge_list(const edge_list&)> solve;
+};
+
+// small weights from the endpoints in the order given, so the two copies of a
+// repeated edge can weigh differently
+std::vector<std::int64_t> edgeWeights(const edge_list& edges)
+{
+    std::vector<std::int64_t> weights(edges.size() / 2);
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        weights[i] = static_cast<std::int64_t>((edges[2 * i] * 7 + edges[2 * i + 1] * 13) % 5);
+    }
+
+    return weights;
+}
+
+// the C API with a buffer one value short first, which must be refused untouched
+edge_list cMatching(const edge_list& edges)
+{
+    std::size_t size = 0;
+    auto status = blossom_matching(edges.data(), edges.size() / 2, BLOSSOM_ENGINE_EDMONDS, nullptr, 0, &size);
+    expect(status == (size == 0 ? BLOSSOM_OK : BLOSSOM_BUFFER_TOO_SMALL), std::string("sizing call returned ")
+        + blossom_status_string(status));
+    expect(size <= edges.size(), "matching size " + std::to_string(size) + " exceeds the documented bound");
+
+    constexpr node_t untouched = std::numeric_limits<node_t>::max();
+    edge_list matching(size, untouched);
+    if (size != 0)
+    {
+        std::size_t needed = 0;
+        status = blossom_matching(edges.data(), edges.size() / 2, BLOSSOM_ENGINE_EDMONDS, matching.data(), size - 1,
+            &needed);
+        expect(status == BLOSSOM_BUFFER_TOO_SMALL && needed == size, "short buffer was not refused");
+        expect(std::all_of(matching.begin(), matching.end(), [](node_t v) { return v == untouched; }),
+            "short buffer was written to");
+    }
+
+    status = blossom_matching(edges.data(), edges.size() / 2, BLOSSOM_ENGINE_EDMONDS, matching.data(),
+        matching.size(), &size);
+    expect(status == BLOSSOM_OK && size == matching.size(), std::string("sized call returned ")
+        + blossom_status_string(status));
+    expect(blossom_matching(edges.data(), edges.size() / 2, BLOSSOM_ENGINE_EDMONDS, matching.data(), matching.size(),
+        nullptr) == BLOSSOM_INVALID_ARGUMENT, "missing size output was accepted");
+    return matching;
+}
+
+std::vector<solver> solvers()
+{
+    std::vector<solver> ret;
+    for (auto [name, engine] : {std::pair{"contraction", matching_engine::contraction},
+        std::pair{"edmonds", matching_engine::edmonds}, std::pair{"phased", matching_engine::phased},
+        std::pair{"parallel", matching_engine::parallel}})
+    {
+        ret.push_back({name, [engine](const edge_list& edges) { return blossom(edges, engine); }});
+    }
+
+    ret.push_back({"task", [](const edge_list& edges)
+    {
+        solve_task task(edges, false);
+        while (task.step(1) == task_status::running)
+        {
+        }
+
+        expect(task.status() == task_status::done, "task stopped without finishing");
+        expect(task.matched_nodes() == task.matching().size(), "task progress disagrees with its matching");
+        return task.matching();
+    }});
+
+    ret.push_back({"partitioned", [](const edge_list& edges)
+    {
+        partition_options options;
+        options.patchNodes = std::max<std::size_t>(2, edges.size() / 6);
+        options.repairHops = 2;
+        return blossomPartitioned(edges, options);
+    }});
+
+    ret.push_back({"weighted", [](const edge_list& edges) { return blossomWeighted(edges, edgeWeights(edges)); }});
+    ret.push_back({"c api", cMatching});
+
+    return ret;
+}
+
+std::string edgeString(const edge_list& edges)
+{
+    std::ostringstream out;
+    for (std::size_t i = 0; i + 1 < edges.size(); i += 2)
+    {
+        out << (i == 0 ? "" : ", ") << edges[i] << " " << edges[i + 1];
+    }
+
+    return out.str();
+}
+
+// --- entry points with more to them than one matching ---
+
+void checkWeight(const adjacency& graph, const edge_list& edges)
+{
+    auto weights = edgeWeights(edges);
+    constexpr std::int64_t none = std::numeric_limits<std::int64_t>::max();
+    std::vector<std::vector<std::int64_t>> lightest(graph.size(), std::vector<std::int64_t>(graph.size(), none));
+    for (std::size_t i = 0; i < weights.size(); ++i)
+    {
+        node_t v1 = edges[2 * i];
+        node_t v2 = edges[2 * i + 1];
+        lightest[v1][v2] = lightest[v2][v1] = std::min(lightest[v1][v2], weights[i]);
+    }
+
+    auto matching = blossomWeighted(edges, weights);
+    std::int64_t weight = 0;
+    for (std::size_t i = 0; i < matching.size(); i += 2)
+    {
+        weight += lightest[matching[i]][matching[i + 1]];
+    }
+
+    std::int64_t expected = bruteForceWeight(graph, lightest);
+    expect(weight == expected, "matching of weight " + std::to_string(weight) + ", exhaustive search found "
+        + std::to_string(expected));
+}
+
+void checkCCycle(const adjacency& graph, const edge_list& edges, bool cubic)
+{
+    std::size_t cycleSize = 0;
+    std::size_t subdivisionsSize = 0;
+    auto status = blossom_hamiltonian_cycle(edges.data(), edges.size() / 2, BLOSSOM_ENGINE_EDMONDS, nullptr, 0,
+        &cycleSize, nullptr, 0, &subdivisionsSize);
+    expect(status == (cycleSize + subdivisionsSize == 0 ? BLOSSOM_OK : BLOSSOM_BUFFER_TOO_SMALL),
+        std::string("sizing call returned ") + blossom_status_string(status));
+    std::size_t maxMerges = std::min(edges.size() / 2, graph.size() / 2);
+    expect(cycleSize <= edges.size() + 2 * maxMerges && subdivisionsSize <= 4 * maxMerges, "cycle of "
+        + std::to_string(cycleSize) + " and subdivisions of " + std::to_string(subdivisionsSize)
+        + " values exceed the documented bounds");
+
+    // ids whose twins would pass the largest id are refused before anything is solved
+    constexpr node_t last = std::numeric_limits<node_t>::max() - 1;
+    edge_list overflowing = {last, last - 1};
+    std::size_t unused = 0;
+    expect(blossom_hamiltonian_cycle(overflowing.data(), 1, BLOSSOM_ENGINE_EDMONDS, nullptr, 0, &unused, nullptr, 0,
+        &unused) == BLOSSOM_INVALID_ARGUMENT, "twins past the largest id were accepted");
+
+    edge_list cycle(cycleSize);
+    edge_list subdivisions(subdivisionsSize);
+    status = blossom_hamiltonian_cycle(edges.data(), edges.size() / 2, BLOSSOM_ENGINE_EDMONDS, cycle.data(),
+        cycle.size(), &cycleSize, subdivisions.data(), subdivisions.size(), &subdivisionsSize);
+    expect(status == BLOSSOM_OK && cycleSize == cycle.size() && subdivisionsSize == subdivisions.size(),
+        std::string("sized call returned ") + blossom_status_string(status));
+    checkCycle(graph, cycle, subdivisions, cubic);
+}
+
+// hamiltonianOrder() lists every node and twin once, and the strip of a mesh has its
+// faces once each, a face split at a midpoint as its two halves, and nothing else
+void checkOrder(const adjacency& graph, const edge_list& edges)
+{
+    auto [order, subdivisions] = hamiltonianOrder(edges);
+    std::vector<int> seen(graph.size() + subdivisions.size() / 2, 0);
+    for (node_t v : order)
+    {
+        expect(v < seen.size() && seen[v]++ == 0, "node " + std::to_string(v) + " repeated or out of range in order");
+    }
+
+    expect(order.size() == seen.size(), "order has " + std::to_string(order.size()) + " of "
+        + std::to_string(seen.size()) + " nodes");
+}
+
+void checkStrip(const std::vector<node_t>& triangles, const triangle_strip& strip)
+{
+    node_t numVertices = triangles.empty() ? 0 : *std::max_element(triangles.begin(), triangles.end()) + 1;
+    using face = std::array<node_t, 3>;
+    auto canonical = [](face f)
+    {
+        std::rotate(f.begin(), std::min_element(f.begin(), f.end()), f.end());
+        return f;
+    };
+
+    // whole faces count two halves each, so a face split in two also counts two
+    std::map<face, std::size_t> remaining;
+    for (std::size_t i = 0; i + 2 < triangles.size(); i += 3)
+    {
+        remaining[canonical({triangles[i], triangles[i + 1], triangles[i + 2]})] += 2;
+    }
+
+    std::size_t count = 0;
+    for (std::size_t i = 0; i + 2 < strip.indices.size(); ++i)
+    {
+        face t = {strip.indices[i], strip.indices[i + 1], strip.indices[i + 2]};
+        if (t[0] == t[1] || t[1] == t[2] || t[0] == t[2])
+        {
+            continue;
+        }
+
+        if (i % 2 == 1)
+        {
+            std::swap(t[0], t[1]);
+        }
+
+        ++count;
+        std::size_t halves = 2;
+        auto m = std::find_if(t.begin(), t.end(), [numVertices](node_t v) { return v >= numVertices; });
+        if (m != t.end())
+        {
+            // (m, p, q) is a half of the face the split edge a b ran through
+            std::size_t k = 2 * (*m - numVertices);
+            expect(k + 1 < strip.midpoints.size(), "strip vertex " + std::to_string(*m) + " is no midpoint");
+            std::rotate(t.begin(), m, t.end());
+            node_t a = strip.midpoints[k];
+            node_t b = strip.midpoints[k + 1];
+            auto other = [a, b](node_t v) { return v == a ? b : a; };
+            bool before = t[1] == a || t[1] == b;
+            expect(before || t[2] == a || t[2] == b, "strip triangle at a midpoint misses its edge");
+            t = before ? face{other(t[1]), t[1], t[2]} : face{t[2], other(t[2]), t[1]};
+            halves = 1;
+        }
+
+        auto it = remaining.find(canonical(t));
+        expect(it != remaining.end() && it->second >= halves, "strip triangle " + std::to_string(t[0]) + " "
+            + std::to_string(t[1]) + " " + std::to_string(t[2]) + " is not a face, or repeats one");
+        it->second -= halves;
+    }
+
+    for (const auto& [f, left] : remaining)
+    {
+        expect(left == 0, "face " + std::to_string(f[0]) + " " + std::to_string(f[1]) + " " + std::to_string(f[2])
+            + " is missing from the strip");
+    }
+
+    expect(count == triangles.size() / 3 + strip.midpoints.size(), "strip has " + std::to_string(count)
+        + " triangles for " + std::to_string(triangles.size() / 3) + " faces and "
+        + std::to_string(strip.midpoints.size() / 2) + " splits");
+}
+
+// a cold cache solves and writes, a second one over the same directory must serve
+// the same results for the edges listed backwards
+void checkCache(const adjacency& graph, const test_case& test, std::size_t reference,
+        const std::filesystem::path& directory)
+{
+    std::filesystem::remove_all(directory);
+    edge_list matching;
+    std::pair<edge_list, edge_list> cycle;
+    {
+        result_cache cold(directory);
+        matching = cold.blossom(test.edges);
+        cycle = cold.hamiltonianCycle(test.edges);
+        expect(cold.misses() == 1, "cold cache solved " + std::to_string(cold.misses()) + " times");
+    }
+
+    checkMatching(graph, matching);
+    expect(matching.size() / 2 == reference, "cached matching of size " + std::to_string(matching.size() / 2)
+        + " instead of " + std::to_string(reference));
+    checkCycle(graph, cycle.first, cycle.second, test.closed);
+
+    edge_list reversed(test.edges.rbegin(), test.edges.rend());
+    result_cache warm(directory);
+    expect(warm.blossom(reversed) == matching, "matching changed on the way through the disk");
+    expect(warm.hamiltonianCycle(reversed) == cycle, "cycle changed on the way through the disk");
+    expect(warm.hits() == 2 && warm.misses() == 0, "warm cache solved " + std::to_string(warm.misses()) + " times");
+}
+
+std::size_t countComponents(std::size_t numNodes, const edge_list& edges)
+{
+    std::vector<node_t> parent(numNodes);
+    std::iota(parent.begin(), parent.end(), node_t{0});
+    auto find = [&parent](node_t v)
+    {
+        while (parent[v] != v)
+        {
+            v = parent[v] = parent[parent[v]];
+        }
+
+        return v;
+    };
+
+    std::size_t count = numNodes;
+    for (std::size_t i = 0; i + 1 < edges.size(); i += 2)
+    {
+        node_t root1 = find(edges[i]);
+        node_t root2 = find(edges[i + 1]);
+        if (root1 != root2)
+        {
+            parent[root1] = root2;
+            --count;
+        }
+    }
+
+    return count;
+}
+
+// the subdivided edges, taken as edges between components of the matching's
+// complement, have to form a forest; one that closed a loop would split a cycle of the
+// Hamiltonian cycle again instead of merging two
+void checkMerges(const adjacency& graph, const std::vector<node_t>& mate, const edge_list& subdivisions)
+{
+    edge_list complement;
+    for (node_t v = 0; v < graph.size(); ++v)
+    {
+        for (node_t w : graph.neighbors[v])
+        {
+            if (v < w && mate[v] != w)
+            {
+                addEdge(complement, v, w);
+            }
+        }
+    }
+
+    std::size_t before = countComponents(graph.size(), complement);
+    for (std::size_t i = 0; i + 3 < subdivisions.size(); i += 4)
+    {
+        addEdge(complement, subdivisions[i], subdivisions[i + 2]);
+    }
+
+    std::size_t after = countComponents(graph.size(), complement);
+    expect(after + subdivisions.size() / 4 == before, std::to_string(subdivisions.size() / 4)
+        + " subdivisions took " + std::to_string(before) + " components to " + std::to_string(after));
+}
+
+// rounds of random edits: removed edges, a removed node, added edges that may name
+// new nodes; after each the session must hold a maximum matching of the edited graph
+void checkSession(const test_case& test, std::size_t reference, std::mt19937& rng)
+{
+    matching_session<node_t> session{std::span<const node_t>(test.edges)};
+    adjacency graph(test.edges);
+    auto matching = session.matching();
+    auto initialMate = checkMatching(graph, matching);
+    expect(matching.size() / 2 == reference && session.size() == reference, "session matching of size "
+        + std::to_string(matching.size() / 2) + " instead of " + std::to_string(reference));
+    auto [cycle, subdivisions] = session.hamiltonian_cycle();
+    checkCycle(graph, cycle, subdivisions, test.closed);
+    checkMerges(graph, initialMate, subdivisions);
+
+    edge_list edges = test.edges;
+    for (int round = std::uniform_int_distribution<int>(1, 4)(rng); round > 0; --round)
+    {
+        auto numNodes = static_cast<node_t>(session.num_nodes());
+        edge_list removed;
+        for (int i = std::uniform_int_distribution<int>(0, 3)(rng); i > 0 && !edges.empty(); --i)
+        {
+            std::size_t k = 2 * std::uniform_int_distribution<std::size_t>(0, edges.size() / 2 - 1)(rng);
+            addEdge(removed, edges[k], edges[k + 1]);
+        }
+
+        edge_list removedNodes;
+        if (numNodes != 0 && std::bernoulli_distribution(0.25)(rng))
+        {
+            removedNodes.push_back(std::uniform_int_distribution<node_t>(0, numNodes - 1)(rng));
+        }
+
+        edge_list added;
+        std::uniform_int_distribution<node_t> anyNode(0, numNodes + 1);
+        for (int i = std::uniform_int_distribution<int>(0, 3)(rng); i > 0; --i)
+        {
+            node_t v1 = anyNode(rng);
+            node_t v2 = anyNode(rng);
+            if (v1 != v2)
+            {
+                addEdge(added, v1, v2);
+            }
+        }
+
+        session.update(added, removed, removedNodes);
+
+        // removals apply before additions, as update() does them
+        edge_list next;
+        auto nodeRemoved = [&removedNodes](node_t v)
+        {
+            return std::find(removedNodes.begin(), removedNodes.end(), v) != removedNodes.end();
+        };
+
+        for (std::size_t i = 0; i + 1 < edges.size(); i += 2)
+        {
+            node_t v1 = edges[i];
+            node_t v2 = edges[i + 1];
+            bool drop = nodeRemoved(v1) || nodeRemoved(v2);
+            for (std::size_t k = 0; k < removed.size() && !drop; k += 2)
+            {
+                drop = (removed[k] == v1 && removed[k + 1] == v2) || (removed[k] == v2 && removed[k + 1] == v1);
+            }
+
+            if (!drop)
+            {
+                addEdge(next, v1, v2);
+            }
+        }
+
+        next.insert(next.end(), added.begin(), added.end());
+        edges = std::move(next);
+
+        // twins are numbered from the session's node count, which keeps nodes whose
+        // edges are all gone
+        adjacency edited(edges, session.num_nodes());
+        matching = session.matching();
+        auto mate = checkMatching(edited, matching);
+        std::size_t expected = blossom(edges).size() / 2;
+        expect(matching.size() / 2 == expected && session.size() == expected, "session matching of size "
+            + std::to_string(matching.size() / 2) + " after an edit, blossom() found " + std::to_string(expected));
+
+        auto [editedCycle, editedSubdivisions] = session.hamiltonian_cycle();
+        checkCycle(edited, editedCycle, editedSubdivisions, false);
+        checkMerges(edited, mate, editedSubdivisions);
+    }
+}
+
+void runCase(const test_case& test, const std::vector<solver>& engines, std::size_t bruteForceNodes,
+        std::mt19937& rng, const std::filesystem::path& cacheDirectory)
+{
+    adjacency graph(test.edges);
+    // the size every engine has to reach, and who found it
+    std::size_t reference = 0;
+    std::string referenceSource;
+    if (graph.size() <= bruteForceNodes)
+    {
+        reference = bruteForceMatching(graph);
+        referenceSource = "exhaustive search";
+    }
+
+    for (const auto& engine : engines)
+    {
+        std::size_t size = 0;
+        std::vector<node_t> mate;
+        try
+        {
+            auto matching = engine.solve(test.edges);
+            mate = checkMatching(graph, matching);
+            size = matching.size() / 2;
+            if (!referenceSource.empty())
+            {
+                expect(size == reference, "matching of size " + std::to_string(size) + ", " + referenceSource
+                    + " found " + std::to_string(reference));
+            }
+            else
+            {
+                checkTutteBerge(graph, size, mate, test.edges);
+                reference = size;
+                referenceSource = engine.name + " with a Tutte-Berge certificate";
+            }
+        }
+        catch (const check_failure& e)
+        {
+            throw check_failure(engine.name + ": " + e.what());
+        }
+    }
+
+    try
+    {
+        auto [cycle, subdivisions] = hamiltonianCycle(test.edges);
+        checkCycle(graph, cycle, subdivisions, test.closed);
+        if (!test.triangles.empty())
+        {
+            // twins are numbered from the face count here, which open meshes may have past the last edge
+            auto [fromTriangles, triangleSubdivisions] = hamiltonianCycleFromTriangles(test.triangles);
+            checkCycle(adjacency(test.edges, test.triangles.size() / 3), fromTriangles, triangleSubdivisions,
+                test.closed);
+        }
+    }
+    catch (const check_failure& e)
+    {
+        throw check_failure(std::string("hamiltonianCycle: ") + e.what());
+    }
+
+    auto labelled = [](const std::string& name, const std::function<void()>& check)
+    {
+        try
+        {
+            check();
+        }
+        catch (const check_failure& e)
+        {
+            throw check_failure(name + ": " + e.what());
+        }
+    };
+
+    if (graph.size() <= bruteForceNodes)
+    {
+        labelled("weighted", [&]() { checkWeight(graph, test.edges); });
+    }
+
+    labelled("hamiltonianOrder", [&]() { checkOrder(graph, test.edges); });
+    if (!test.triangles.empty())
+    {
+        labelled("triangleStrip", [&]() { checkStrip(test.triangles, triangleStrip(test.triangles, test.edges)); });
+        labelled("triangleStripFromTriangles", [&]()
+        {
+            checkStrip(test.triangles, triangleStripFromTriangles(test.triangles));
+        });
+    }
+
+    labelled("c api cycle", [&]() { checkCCycle(graph, test.edges, test.closed); });
+    labelled("result_cache", [&]() { checkCache(graph, test, reference, cacheDirectory); });
+    labelled("matching_session", [&]() { checkSession(test, reference, rng); });
+}
+
+void usage(const char* argv0)
+{
+    std::cerr << "usage: " << argv0 << " [--seed N] [--cases N] [--max-nodes N] [--threads N]\n"
+        << "  Solves --cases generated graphs (default 300) of up to --max-nodes nodes\n"
+        << "  (default 200) with every engine and checks the results. Case i uses seed\n"
+        << "  N + i; a failure prints that seed, --seed with --cases 1 runs the case alone.\n"
+        << "  The parallel engine and the patch pool use --threads workers (default 4) however\n"
+        << "  many cores there are; build with -DBLOSSOM_SANITIZE=thread to race check them.\n";
+}
+
+}
+
+int main(int argc, char** argv)
+{
+    std::uint32_t seed = 1;
+    std::size_t numCases = 300;
+    std::size_t maxNodes = 200;
+    std::size_t threads = 4;
+    for (int i = 1; i < argc; ++i)
+    {
+        std::string arg = argv[i];
+        if ((arg == "--seed" || arg == "--cases" || arg == "--max-nodes" || arg == "--threads") && i + 1 < argc)
+        {
+            unsigned long long value = std::strtoull(argv[++i], nullptr, 10);
+            if (arg == "--seed")
+            {
+                seed = static_cast<std::uint32_t>(value);
+            }
+            else if (arg == "--cases")
+            {
+                numCases = value;
+            }
+            else if (arg == "--max-nodes")
+            {
+                maxNodes = std::max<unsigned long long>(value, 1);
+            }
+            else
+            {
+                threads = std::max<unsigned long long>(value, 1);
+            }
+        }
+        else
+        {
+            usage(argv[0]);
+            return arg == "-h" || arg == "--help" ? 0 : 2;
+        }
+    }
+
+    // the parallel engine searches concurrently only while it has more free roots than
+    // workers, which a single worker never does, so the count must not follow the machine
+    setSolverThreads(threads);
+    auto engines = solvers();
+    auto cacheDirectory = std::filesystem::temp_directory_path() / ("hmesh_fuzz-" + std::to_string(seed));
+    int failures = 0;
+    for (std::size_t i = 0; i < numCases; ++i)
+    {
+        std::uint32_t caseSeed = seed + static_cast<std::uint32_t>(i);
+        std::mt19937 rng(caseSeed);
+        test_case test = makeCase(rng, maxNodes);
+        try
+        {
+            runCase(test, engines, 16, rng, cacheDirectory);
+        }
+        catch (const std::exception& e)
+        {
+            std::cerr << "seed " << caseSeed << " (" << test.family << "): " << e.what() << "\n";
+            if (test.edges.size() <= 400)
+            {
+                std::cerr << "  edges: " << edgeString(test.edges) << "\n";
+            }
+
+            ++failures;
+        }
+    }
+
+    std::filesystem::remove_all(cacheDirectory);
+    std::cout << numCases << " cases, " << failures << " failed\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,179 @@
+#include "generators.h"
+
+#include <algorithm>
+#include <random>
+#include <unordered_map>
+
+namespace
+{
+
+std::uint64_t edgeKey(std::uint32_t a, std::uint32_t b)
+{
+    return static_cast<std::uint64_t>(a) << 32 | b;
+}
+
+}
+
+std::vector<std::uint32_t> icosphere(unsigned subdivisions)
+{
+    std::vector<std::uint32_t> triangles{
+        0, 11, 5,   0, 5, 1,    0, 1, 7,    0, 7, 10,   0, 10, 11,
+        1, 5, 9,    5, 11, 4,   11, 10, 2,  10, 7, 6,   7, 1, 8,
+        3, 9, 4,    3, 4, 2,    3, 2, 6,    3, 6, 8,    3, 8, 9,
+        4, 9, 5,    2, 4, 11,   6, 2, 10,   8, 6, 7,    9, 8, 1
+    };
+    std::uint32_t numVertices = 12;
+
+    for (unsigned level = 0; level < subdivisions; ++level)
+    {
+        std::unordered_map<std::uint64_t, std::uint32_t> midpoints;
+        auto midpoint = [&](std::uint32_t a, std::uint32_t b)
+        {
+            auto [it, inserted] = midpoints.try_emplace(edgeKey(std::min(a, b), std::max(a, b)), numVertices);
+            numVertices += inserted;
+            return it->second;
+        };
+
+        std::vector<std::uint32_t> next;
+        next.reserve(triangles.size() * 4);
+        for (std::size_t i = 0; i < triangles.size(); i += 3)
+        {
+            std::uint32_t a = triangles[i];
+            std::uint32_t b = triangles[i + 1];
+            std::uint32_t c = triangles[i + 2];
+            std::uint32_t ab = midpoint(a, b);
+            std::uint32_t bc = midpoint(b, c);
+            std::uint32_t ca = midpoint(c, a);
+            next.insert(next.end(), {a, ab, ca, b, bc, ab, c, ca, bc, ab, bc, ca});
+        }
+
+        triangles = std::move(next);
+    }
+
+    return triangles;
+}
+
+std::vector<std::uint32_t> torus(std::size_t rings, std::size_t segments)
+{
+    std::vector<std::uint32_t> triangles;
+    triangles.reserve(rings * segments * 6);
+    auto vertex = [&](std::size_t i, std::size_t j)
+    {
+        return static_cast<std::uint32_t>((i % rings) * segments + j % segments);
+    };
+
+    for (std::size_t i = 0; i < rings; ++i)
+    {
+        for (std::size_t j = 0; j < segments; ++j)
+        {
+            triangles.insert(triangles.end(), {vertex(i, j), vertex(i + 1, j), vertex(i + 1, j + 1)});
+            triangles.insert(triangles.end(), {vertex(i, j), vertex(i + 1, j + 1), vertex(i, j + 1)});
+        }
+    }
+
+    return triangles;
+}
+
+std::vector<std::uint32_t> randomTriangulation(std::size_t faces, std::uint32_t seed)
+{
+    std::mt19937 rng(seed);
+    std::vector<std::uint32_t> triangles{0, 1, 2,   0, 3, 1,   1, 3, 2,   2, 3, 0};
+    std::vector<std::size_t> degree(4, 3);
+
+    while (triangles.size() / 3 + 2 <= faces)
+    {
+        std::size_t f = rng() % (triangles.size() / 3) * 3;
+        std::uint32_t a = triangles[f];
+        std::uint32_t b = triangles[f + 1];
+        std::uint32_t c = triangles[f + 2];
+        auto d = static_cast<std::uint32_t>(degree.size());
+        degree.push_back(3);
+        ++degree[a];
+        ++degree[b];
+        ++degree[c];
+        triangles[f + 2] = d;
+        triangles.insert(triangles.end(), {b, c, d, c, a, d});
+    }
+
+    // directed edge -> face owning it, the opposite face owns the reversed edge
+    std::unordered_map<std::uint64_t, std::size_t> owner;
+    owner.reserve(triangles.size());
+    for (std::size_t f = 0; f < triangles.size(); f += 3)
+    {
+        for (std::size_t k = 0; k < 3; ++k)
+        {
+            owner[edgeKey(triangles[f + k], triangles[f + (k + 1) % 3])] = f;
+        }
+    }
+
+    for (std::size_t attempt = 0; attempt < faces; ++attempt)
+    {
+        std::size_t f1 = rng() % (triangles.size() / 3) * 3;
+        std::size_t k = rng() % 3;
+        std::uint32_t a = triangles[f1 + k];
+        std::uint32_t b = triangles[f1 + (k + 1) % 3];
+        std::uint32_t c = triangles[f1 + (k + 2) % 3];
+        std::size_t f2 = owner.at(edgeKey(b, a));
+        std::uint32_t d = 0;
+        for (std::size_t i = 0; i < 3; ++i)
+        {
+            if (triangles[f2 + i] != a && triangles[f2 + i] != b)
+            {
+                d = triangles[f2 + i];
+            }
+        }
+
+        if (degree[a] <= 3 || degree[b] <= 3 || owner.contains(edgeKey(c, d)))
+        {
+            continue;
+        }
+
+        // (a, b, c) + (b, a, d) -> (c, a, d) + (d, b, c)
+        owner.erase(edgeKey(a, b));
+        owner.erase(edgeKey(b, a));
+        triangles[f1] = c;
+        triangles[f1 + 1] = a;
+        triangles[f1 + 2] = d;
+        triangles[f2] = d;
+        triangles[f2 + 1] = b;
+        triangles[f2 + 2] = c;
+        owner[edgeKey(c, a)] = f1;
+        owner[edgeKey(a, d)] = f1;
+        owner[edgeKey(d, c)] = f1;
+        owner[edgeKey(d, b)] = f2;
+        owner[edgeKey(b, c)] = f2;
+        owner[edgeKey(c, d)] = f2;
+        --degree[a];
+        --degree[b];
+        ++degree[c];
+        ++degree[d];
+    }
+
+    return triangles;
+}
+
+std::vector<std::uint32_t> longStrip(std::size_t length)
+{
+    auto triangles = torus(length, 3);
+    auto numVertices = static_cast<std::uint32_t>(length * 3);
+
+    // (a, b, c) -> (a, b, d) + (b, c, d) + (c, a, d) around a new centre vertex d,
+    // the second pass turns every ring of three faces into a ring of three rings
+    for (int level = 0; level < 2; ++level)
+    {
+        std::vector<std::uint32_t> next;
+        next.reserve(triangles.size() * 3);
+        for (std::size_t i = 0; i < triangles.size(); i += 3)
+        {
+            std::uint32_t a = triangles[i];
+            std::uint32_t b = triangles[i + 1];
+            std::uint32_t c = triangles[i + 2];
+            std::uint32_t d = numVertices++;
+            next.insert(next.end(), {a, b, d, b, c, d, c, a, d});
+        }
+
+        triangles = std::move(next);
+    }
+
+    return triangles;
+}
@@ -0,0 +1,24 @@
+#ifndef GENERATORS_H
+#define GENERATORS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// synthetic closed triangle meshes as 3 vertex indices per face, consistently oriented
+
+// 20 * 4^subdivisions faces
+std::vector<std::uint32_t> icosphere(unsigned subdivisions);
+
+// 2 * rings * segments faces, both at least 3
+std::vector<std::uint32_t> torus(std::size_t rings, std::size_t segments);
+
+// sphere triangulation grown by random face splits and then scrambled by edge flips
+std::vector<std::uint32_t> randomTriangulation(std::size_t faces, std::uint32_t seed);
+
+// torus only three segments around with every face split about its centre twice,
+// 54 * length faces; the dual is a band of odd rings nested in odd rings on which
+// the greedy warm start strands faces, so every solve has to contract blossoms
+std::vector<std::uint32_t> longStrip(std::size_t length);
+
+#endif
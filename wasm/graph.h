@@ -86,7 +86,8 @@ class graph
             return ret;
         }
 
-        std::size_t add_edges_from(const graph<T>& other)
+        template<typename G>
+        std::size_t add_edges_from(const G& other)
         {
             std::size_t ret = 0;
             for (const auto& e : other.edges())
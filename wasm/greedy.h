@@ -0,0 +1,116 @@
+#ifndef GREEDY_H
+#define GREEDY_H
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <vector>
+
+// Karp-Sipser style maximal matching used to warm start the exact engines:
+// pendant vertices are matched first (always optimal), otherwise the vertex of
+// minimum remaining degree is matched to its minimum degree neighbor
+template<typename Graph>
+std::vector<typename Graph::node_type> greedyMatching(const Graph& graph)
+{
+    using node_type = typename Graph::node_type;
+    constexpr node_type npos = std::numeric_limits<node_type>::max();
+
+    std::size_t n = graph.num_nodes();
+    std::vector<node_type> mate(n, npos);
+    std::vector<std::size_t> degree(n);
+    std::vector<node_type> pendants;
+    std::vector<std::vector<node_type>> buckets;
+    for (std::size_t v = 0; v < n; ++v)
+    {
+        degree[v] = graph.degree(static_cast<node_type>(v));
+        if (degree[v] == 1)
+        {
+            pendants.push_back(static_cast<node_type>(v));
+        }
+        else if (degree[v] > 1)
+        {
+            if (degree[v] >= buckets.size())
+            {
+                buckets.resize(degree[v] + 1);
+            }
+
+            buckets[degree[v]].push_back(static_cast<node_type>(v));
+        }
+    }
+
+    // bucket entries are lazy, anything stale is skipped when popped
+    std::size_t minBucket = 2;
+    auto match = [&](node_type v1, node_type v2)
+    {
+        mate[v1] = v2;
+        mate[v2] = v1;
+        for (node_type v : {v1, v2})
+        {
+            for (const auto& w : graph.edges_of_node(v))
+            {
+                if (mate[w] == npos && --degree[w] > 0)
+                {
+                    if (degree[w] == 1)
+                    {
+                        pendants.push_back(w);
+                    }
+                    else
+                    {
+                        buckets[degree[w]].push_back(w);
+                        minBucket = std::min(minBucket, degree[w]);
+                    }
+                }
+            }
+        }
+    };
+
+    auto freeNeighbor = [&](node_type v)
+    {
+        node_type best = npos;
+        for (const auto& w : graph.edges_of_node(v))
+        {
+            if (mate[w] == npos && (best == npos || degree[w] < degree[best]))
+            {
+                best = w;
+            }
+        }
+
+        return best;
+    };
+
+    while (true)
+    {
+        if (!pendants.empty())
+        {
+            node_type v = pendants.back();
+            pendants.pop_back();
+            if (mate[v] == npos && degree[v] == 1)
+            {
+                match(v, freeNeighbor(v));
+            }
+
+            continue;
+        }
+
+        while (minBucket < buckets.size() && buckets[minBucket].empty())
+        {
+            ++minBucket;
+        }
+
+        if (minBucket >= buckets.size())
+        {
+            break;
+        }
+
+        node_type v = buckets[minBucket].back();
+        buckets[minBucket].pop_back();
+        if (mate[v] == npos && degree[v] == minBucket)
+        {
+            match(v, freeNeighbor(v));
+        }
+    }
+
+    return mate;
+}
+
+#endif
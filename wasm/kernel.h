@@ -0,0 +1,283 @@
+#ifndef KERNEL_H
+#define KERNEL_H
+
+#include "csr_graph.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <limits>
+#include <span>
+#include <vector>
+
+// Reduces a graph to a kernel of minimum degree 3 with the same maximum matching
+// size up to a known offset, the way open meshes give many low degree dual nodes:
+// a pendant vertex is matched to its neighbor, and a degree 2 vertex v with
+// neighbors u and w is folded, u and w becoming one vertex in place of the three.
+// Any maximum matching of the kernel expands back to one of the input graph by
+// undoing the reductions last to first.
+template<typename T>
+class matching_kernel
+{
+    public:
+        using node_type = T;
+        static constexpr node_type npos = std::numeric_limits<node_type>::max();
+
+    private:
+        enum class reduction_kind { pendant, fold };
+
+        // for a fold u is the merged vertex, and the neighbors w had at the time
+        // are kept in foldNeighbors to tell which side a later mate of u came from
+        struct reduction
+        {
+            reduction_kind kind;
+            node_type v;
+            node_type u;
+            node_type w;
+            std::size_t neighborsBegin;
+            std::size_t neighborsEnd;
+        };
+
+        std::size_t numNodes;
+        // adjacency lists live in one pool; a fold appends the merged list, and
+        // entries go stale (dead or merged vertices, duplicates) until compacted
+        std::vector<node_type> pool;
+        std::vector<std::size_t> listBegin;
+        std::vector<std::size_t> listSize;
+        std::vector<node_type> merged;
+        std::vector<bool> alive;
+        std::vector<std::size_t> seen;
+        std::size_t stamp;
+        std::vector<reduction> reductions;
+        std::vector<node_type> foldNeighbors;
+        std::vector<node_type> kernelIds;
+        std::vector<node_type> originalIds;
+        std::vector<node_type> kernelEdges;
+        std::size_t numPendants;
+        std::size_t numFolds;
+
+        node_type find(node_type v)
+        {
+            while (merged[v] != v)
+            {
+                merged[v] = merged[merged[v]];
+                v = merged[v];
+            }
+
+            return v;
+        }
+
+        // compacts the list of v to its distinct live neighbors, returning their number
+        std::size_t compact(node_type v)
+        {
+            ++stamp;
+            std::size_t begin = listBegin[v];
+            std::size_t write = begin;
+            for (std::size_t i = begin; i < begin + listSize[v]; ++i)
+            {
+                node_type w = find(pool[i]);
+                if (w != v && alive[w] && seen[w] != stamp)
+                {
+                    seen[w] = stamp;
+                    pool[write++] = w;
+                }
+            }
+
+            listSize[v] = write - begin;
+            return listSize[v];
+        }
+
+        void reduce(std::vector<node_type>& queue)
+        {
+            while (!queue.empty())
+            {
+                node_type v = find(queue.back());
+                queue.pop_back();
+                if (!alive[v])
+                {
+                    continue;
+                }
+
+                std::size_t degree = compact(v);
+                if (degree == 0)
+                {
+                    alive[v] = false;
+                }
+                else if (degree == 1)
+                {
+                    node_type u = pool[listBegin[v]];
+                    alive[v] = alive[u] = false;
+                    reductions.push_back({reduction_kind::pendant, v, u, npos, 0, 0});
+                    ++numPendants;
+                    queue.insert(queue.end(), pool.begin() + static_cast<std::ptrdiff_t>(listBegin[u]),
+                        pool.begin() + static_cast<std::ptrdiff_t>(listBegin[u] + listSize[u]));
+                }
+                else if (degree == 2)
+                {
+                    node_type u = pool[listBegin[v]];
+                    node_type w = pool[listBegin[v] + 1];
+                    alive[v] = false;
+                    compact(u);
+                    compact(w);
+
+                    std::size_t neighborsBegin = foldNeighbors.size();
+                    foldNeighbors.insert(foldNeighbors.end(), pool.begin() + static_cast<std::ptrdiff_t>(listBegin[w]),
+                        pool.begin() + static_cast<std::ptrdiff_t>(listBegin[w] + listSize[w]));
+                    reductions.push_back({reduction_kind::fold, v, u, w, neighborsBegin, foldNeighbors.size()});
+                    ++numFolds;
+
+                    // an edge between u and w becomes a loop and is dropped by compact()
+                    std::size_t begin = pool.size();
+                    for (node_type x : {u, w})
+                    {
+                        for (std::size_t i = listBegin[x]; i < listBegin[x] + listSize[x]; ++i)
+                        {
+                            pool.push_back(pool[i]);
+                        }
+                    }
+
+                    merged[w] = u;
+                    alive[w] = false;
+                    listBegin[u] = begin;
+                    listSize[u] = pool.size() - begin;
+
+                    // u may now have low degree, and so may neighbors it shared with w
+                    queue.push_back(u);
+                    queue.insert(queue.end(), foldNeighbors.begin() + static_cast<std::ptrdiff_t>(neighborsBegin),
+                        foldNeighbors.end());
+                }
+            }
+        }
+
+    public:
+        explicit matching_kernel(const csr_graph<T>& graph): numNodes(graph.num_nodes()), pool(), listBegin(numNodes),
+            listSize(numNodes), merged(numNodes), alive(numNodes), seen(numNodes, 0), stamp(0), reductions(),
+            foldNeighbors(), kernelIds(numNodes, npos), originalIds(), kernelEdges(), numPendants(0), numFolds(0)
+        {
+            std::vector<node_type> queue;
+            pool.reserve(2 * graph.num_edges());
+            for (std::size_t v = 0; v < numNodes; ++v)
+            {
+                auto row = graph.edges_of_node(static_cast<node_type>(v));
+                listBegin[v] = pool.size();
+                listSize[v] = row.size();
+                pool.insert(pool.end(), row.begin(), row.end());
+                merged[v] = static_cast<node_type>(v);
+                alive[v] = !row.empty();
+                if (row.size() == 1 || row.size() == 2)
+                {
+                    queue.push_back(static_cast<node_type>(v));
+                }
+            }
+
+            reduce(queue);
+
+            for (std::size_t v = 0; v < numNodes; ++v)
+            {
+                if (alive[v])
+                {
+                    kernelIds[v] = static_cast<node_type>(originalIds.size());
+                    originalIds.push_back(static_cast<node_type>(v));
+                }
+            }
+
+            for (const auto& v : originalIds)
+            {
+                compact(v);
+                for (std::size_t i = listBegin[v]; i < listBegin[v] + listSize[v]; ++i)
+                {
+                    if (v < pool[i])
+                    {
+                        kernelEdges.push_back(kernelIds[v]);
+                        kernelEdges.push_back(kernelIds[pool[i]]);
+                    }
+                }
+            }
+        }
+
+        // true if the graph has a vertex of degree 1 or 2, closed meshes have none
+        static bool reducible(const csr_graph<T>& graph)
+        {
+            for (std::size_t v = 0; v < graph.num_nodes(); ++v)
+            {
+                std::size_t degree = graph.degree(static_cast<node_type>(v));
+                if (degree == 1 || degree == 2)
+                {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // kernel nodes are renumbered densely from 0
+        std::span<const node_type> edges() const
+        {
+            return kernelEdges;
+        }
+
+        std::size_t num_nodes() const
+        {
+            return originalIds.size();
+        }
+
+        std::size_t num_pendants() const
+        {
+            return numPendants;
+        }
+
+        std::size_t num_folds() const
+        {
+            return numFolds;
+        }
+
+        // kernelMates is indexed by kernel node, npos where unmatched; the result is
+        // indexed by input node and as large as the input graph
+        std::vector<node_type> expand(const std::vector<node_type>& kernelMates) const
+        {
+            std::vector<node_type> mate(numNodes, npos);
+            for (std::size_t k = 0; k < kernelMates.size() && k < originalIds.size(); ++k)
+            {
+                if (kernelMates[k] != npos)
+                {
+                    mate[originalIds[k]] = originalIds[kernelMates[k]];
+                }
+            }
+
+            for (auto r = reductions.crbegin(); r != reductions.crend(); ++r)
+            {
+                if (r->kind == reduction_kind::pendant)
+                {
+                    mate[r->v] = r->u;
+                    mate[r->u] = r->v;
+                    continue;
+                }
+
+                // the merged vertex was matched through an edge of u or of w, and
+                // whichever of them is left over takes v
+                node_type x = mate[r->u];
+                auto neighborsOfW = std::span<const node_type>(foldNeighbors).subspan(r->neighborsBegin,
+                    r->neighborsEnd - r->neighborsBegin);
+                if (x != npos && std::find(neighborsOfW.begin(), neighborsOfW.end(), x) != neighborsOfW.end())
+                {
+                    mate[r->w] = x;
+                    mate[x] = r->w;
+                    mate[r->u] = r->v;
+                    mate[r->v] = r->u;
+                }
+                else if (x != npos)
+                {
+                    mate[r->w] = r->v;
+                    mate[r->v] = r->w;
+                }
+                else
+                {
+                    mate[r->u] = r->v;
+                    mate[r->v] = r->u;
+                }
+            }
+
+            return mate;
+        }
+};
+
+#endif
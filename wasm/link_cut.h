@@ -0,0 +1,168 @@
+#ifndef LINK_CUT_H
+#define LINK_CUT_H
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+// a forest over integer nodes that can cut edges as well as link them, with
+// connectivity queries in amortized O(log n); union-find cannot take a union back
+// once an edge between the sets is gone. Each tree is kept as splay trees over its
+// preferred paths, ordered by depth from a root that evert() can move
+template<typename T = std::uint32_t>
+class link_cut_forest
+{
+    static constexpr T npos = std::numeric_limits<T>::max();
+
+    // parent is the splay tree parent, or for a splay root the path parent
+    std::vector<T> parent;
+    std::vector<std::array<T, 2>> child;
+    std::vector<std::uint8_t> reversed;
+    std::vector<T> path;
+
+    bool isSplayRoot(T x) const
+    {
+        T p = parent[x];
+        return p == npos || (child[p][0] != x && child[p][1] != x);
+    }
+
+    void push(T x)
+    {
+        if (reversed[x])
+        {
+            std::swap(child[x][0], child[x][1]);
+            for (const auto& c : child[x])
+            {
+                if (c != npos)
+                {
+                    reversed[c] ^= 1;
+                }
+            }
+
+            reversed[x] = 0;
+        }
+    }
+
+    void rotate(T x)
+    {
+        T p = parent[x];
+        T g = parent[p];
+        std::size_t side = child[p][1] == x;
+        if (!isSplayRoot(p))
+        {
+            child[g][child[g][1] == p] = x;
+        }
+
+        parent[x] = g;
+        child[p][side] = child[x][1 - side];
+        if (child[p][side] != npos)
+        {
+            parent[child[p][side]] = p;
+        }
+
+        child[x][1 - side] = p;
+        parent[p] = x;
+    }
+
+    void splay(T x)
+    {
+        // reversals are pushed down from the splay root before anything rotates
+        path.clear();
+        for (T y = x; ; y = parent[y])
+        {
+            path.push_back(y);
+            if (isSplayRoot(y))
+            {
+                break;
+            }
+        }
+
+        for (auto it = path.rbegin(); it != path.rend(); ++it)
+        {
+            push(*it);
+        }
+
+        while (!isSplayRoot(x))
+        {
+            T p = parent[x];
+            if (!isSplayRoot(p))
+            {
+                T g = parent[p];
+                rotate((child[g][1] == p) == (child[p][1] == x) ? p : x);
+            }
+
+            rotate(x);
+        }
+    }
+
+    // makes the path from the root to x preferred, with x at the top of its splay tree
+    void access(T x)
+    {
+        T last = npos;
+        for (T y = x; y != npos; y = parent[y])
+        {
+            splay(y);
+            child[y][1] = last;
+            last = y;
+        }
+
+        splay(x);
+    }
+
+    void evert(T x)
+    {
+        access(x);
+        reversed[x] ^= 1;
+    }
+
+    public:
+        // new nodes are alone in their trees
+        void resize(std::size_t n)
+        {
+            parent.resize(n, npos);
+            child.resize(n, {npos, npos});
+            reversed.resize(n, 0);
+        }
+
+        std::size_t size() const
+        {
+            return parent.size();
+        }
+
+        // the root of x's tree, which stays the same until a link or cut changes the tree
+        T root(T x)
+        {
+            access(x);
+            push(x);
+            while (child[x][0] != npos)
+            {
+                x = child[x][0];
+                push(x);
+            }
+
+            splay(x);
+            return x;
+        }
+
+        // a and b must be in different trees
+        void link(T a, T b)
+        {
+            evert(a);
+            parent[a] = b;
+        }
+
+        // a b must be an edge of the forest
+        void cut(T a, T b)
+        {
+            evert(a);
+            access(b);
+            // a is the only node above b on the path, so it is all of b's left subtree
+            parent[child[b][0]] = npos;
+            child[b][0] = npos;
+        }
+};
+
+#endif
@@ -0,0 +1,486 @@
+#include "mesh_io.h"
+#include "blossom.h"
+
+#include <algorithm>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+namespace
+{
+
+[[noreturn]] void fail(const std::filesystem::path& path, const std::string& what)
+{
+    throw std::runtime_error(path.string() + ": " + what);
+}
+
+[[noreturn]] void fail(const std::filesystem::path& path, std::size_t lineNumber, const std::string& what)
+{
+    fail(std::filesystem::path(path.string() + ":" + std::to_string(lineNumber)), what);
+}
+
+void addPolygon(triangle_mesh& mesh, const std::vector<std::uint32_t>& polygon, const std::filesystem::path& path)
+{
+    for (const auto& v : polygon)
+    {
+        if (v >= mesh.numVertices)
+        {
+            fail(path, "face references vertex " + std::to_string(v) + " out of range");
+        }
+    }
+
+    for (std::size_t i = 2; i < polygon.size(); ++i)
+    {
+        mesh.triangles.push_back(polygon[0]);
+        mesh.triangles.push_back(polygon[i - 1]);
+        mesh.triangles.push_back(polygon[i]);
+    }
+}
+
+triangle_mesh readObj(std::istream& in, const std::filesystem::path& path)
+{
+    triangle_mesh mesh;
+    std::vector<std::uint32_t> polygon;
+    std::string line;
+    std::size_t lineNumber = 0;
+    while (std::getline(in, line))
+    {
+        ++lineNumber;
+        if (line.size() < 2 || !std::isspace(static_cast<unsigned char>(line[1])))
+        {
+            continue;
+        }
+
+        if (line[0] == 'v')
+        {
+            ++mesh.numVertices;
+        }
+        else if (line[0] == 'f')
+        {
+            polygon.clear();
+            std::istringstream tokens(line.substr(2));
+            std::string token;
+            while (tokens >> token)
+            {
+                // v, v/vt, v//vn or v/vt/vn, negative indices count back from the last vertex
+                std::string_view digits(token.data(), std::min(token.find('/'), token.size()));
+                long long index = 0;
+                auto [end, error] = std::from_chars(digits.data(), digits.data() + digits.size(), index);
+                if (error != std::errc() || end != digits.data() + digits.size())
+                {
+                    fail(path, lineNumber, "bad face index " + token);
+                }
+
+                if (index < 0)
+                {
+                    index += static_cast<long long>(mesh.numVertices) + 1;
+                }
+
+                // checked before narrowing, so a huge index cannot wrap into range
+                if (index <= 0 || static_cast<unsigned long long>(index) > mesh.numVertices
+                    || index - 1 > std::numeric_limits<std::uint32_t>::max())
+                {
+                    fail(path, lineNumber, "face index " + token + " out of range");
+                }
+
+                polygon.push_back(static_cast<std::uint32_t>(index - 1));
+            }
+
+            addPolygon(mesh, polygon, path);
+        }
+    }
+
+    return mesh;
+}
+
+bool nextDataLine(std::istream& in, std::string& line)
+{
+    while (std::getline(in, line))
+    {
+        auto start = line.find_first_not_of(" \t\r");
+        if (start != std::string::npos && line[start] != '#')
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// whitespace separated values left on an ascii data line
+std::size_t remainingTokens(std::istringstream& tokens)
+{
+    if (!tokens || tokens.eof())
+    {
+        return 0;
+    }
+
+    std::istringstream rest(tokens.str().substr(static_cast<std::size_t>(tokens.tellg())));
+    std::size_t count = 0;
+    std::string token;
+    while (rest >> token)
+    {
+        ++count;
+    }
+
+    return count;
+}
+
+// bytes between the read position and the end of the file
+std::size_t remainingBytes(std::istream& in)
+{
+    std::streampos position = in.tellg();
+    in.seekg(0, std::ios::end);
+    std::streampos end = in.tellg();
+    in.seekg(position);
+    return position < 0 || end < position ? 0 : static_cast<std::size_t>(end - position);
+}
+
+triangle_mesh readOff(std::istream& in, const std::filesystem::path& path)
+{
+    std::string line;
+    if (!nextDataLine(in, line) || line.find("OFF") == std::string::npos)
+    {
+        fail(path, "missing OFF header");
+    }
+
+    // the counts may share the header line
+    std::istringstream counts(line.substr(line.find("OFF") + 3));
+    std::size_t numVertices = 0;
+    std::size_t numFaces = 0;
+    if (!(counts >> numVertices >> numFaces))
+    {
+        if (!nextDataLine(in, line))
+        {
+            fail(path, "missing element counts");
+        }
+
+        counts = std::istringstream(line);
+        if (!(counts >> numVertices >> numFaces))
+        {
+            fail(path, "bad element counts");
+        }
+    }
+
+    triangle_mesh mesh;
+    mesh.numVertices = numVertices;
+    for (std::size_t i = 0; i < numVertices; ++i)
+    {
+        if (!nextDataLine(in, line))
+        {
+            fail(path, "truncated vertex list");
+        }
+    }
+
+    // the shortest face line, "3 a b c", takes seven bytes
+    if (numFaces > remainingBytes(in) / 7)
+    {
+        fail(path, "face count " + std::to_string(numFaces) + " does not fit in the file");
+    }
+
+    mesh.triangles.reserve(numFaces * 3);
+    std::vector<std::uint32_t> polygon;
+    for (std::size_t i = 0; i < numFaces; ++i)
+    {
+        if (!nextDataLine(in, line))
+        {
+            fail(path, "truncated face list");
+        }
+
+        std::istringstream face(line);
+        std::size_t k = 0;
+        if (!(face >> k) || k < 3 || k > remainingTokens(face))
+        {
+            fail(path, "bad face on line: " + line);
+        }
+
+        polygon.resize(k);
+        for (auto& v : polygon)
+        {
+            if (!(face >> v))
+            {
+                fail(path, "bad face on line: " + line);
+            }
+        }
+
+        addPolygon(mesh, polygon, path);
+    }
+
+    return mesh;
+}
+
+struct ply_property
+{
+    std::string name;
+    std::string type;
+    std::string countType;
+    bool isList = false;
+};
+
+struct ply_element
+{
+    std::string name;
+    std::size_t count = 0;
+    std::vector<ply_property> properties;
+};
+
+std::size_t plyTypeSize(const std::string& type, const std::filesystem::path& path)
+{
+    if (type == "char" || type == "uchar" || type == "int8" || type == "uint8")
+    {
+        return 1;
+    }
+    else if (type == "short" || type == "ushort" || type == "int16" || type == "uint16")
+    {
+        return 2;
+    }
+    else if (type == "int" || type == "uint" || type == "int32" || type == "uint32"
+            || type == "float" || type == "float32")
+    {
+        return 4;
+    }
+    else if (type == "double" || type == "float64")
+    {
+        return 8;
+    }
+
+    fail(path, "unknown PLY type " + type);
+}
+
+double readBinaryScalar(std::istream& in, const std::string& type, bool swapBytes, const std::filesystem::path& path)
+{
+    unsigned char bytes[8];
+    std::size_t size = plyTypeSize(type, path);
+    if (!in.read(reinterpret_cast<char*>(bytes), static_cast<std::streamsize>(size)))
+    {
+        fail(path, "truncated binary data");
+    }
+
+    if (swapBytes)
+    {
+        std::reverse(bytes, bytes + size);
+    }
+
+    auto as = [&bytes]<typename V>(V value)
+    {
+        std::memcpy(&value, bytes, sizeof(V));
+        return static_cast<double>(value);
+    };
+
+    if (type == "char" || type == "int8") return as(std::int8_t{});
+    if (type == "uchar" || type == "uint8") return as(std::uint8_t{});
+    if (type == "short" || type == "int16") return as(std::int16_t{});
+    if (type == "ushort" || type == "uint16") return as(std::uint16_t{});
+    if (type == "int" || type == "int32") return as(std::int32_t{});
+    if (type == "uint" || type == "uint32") return as(std::uint32_t{});
+    if (type == "float" || type == "float32") return as(float{});
+    return as(double{});
+}
+
+// list counts and vertex indices arrive as doubles; they must be whole, not negative
+// and at most limit before they are converted, so a corrupt file is a parse error
+std::uint64_t plyInteger(double value, std::uint64_t limit, const std::string& what,
+        const std::filesystem::path& path)
+{
+    if (!(value >= 0) || value != std::floor(value) || value > static_cast<double>(limit))
+    {
+        std::ostringstream message;
+        message << "bad " << what << " " << value;
+        fail(path, message.str());
+    }
+
+    return static_cast<std::uint64_t>(value);
+}
+
+triangle_mesh readPly(std::istream& in, const std::filesystem::path& path)
+{
+    std::string line;
+    if (!std::getline(in, line) || line.rfind("ply", 0) != 0)
+    {
+        fail(path, "missing PLY magic");
+    }
+
+    std::string format;
+    std::vector<ply_element> elements;
+    while (std::getline(in, line))
+    {
+        std::istringstream tokens(line);
+        std::string keyword;
+        tokens >> keyword;
+        if (keyword == "format")
+        {
+            tokens >> format;
+        }
+        else if (keyword == "element")
+        {
+            ply_element element;
+            tokens >> element.name >> element.count;
+            elements.push_back(element);
+        }
+        else if (keyword == "property")
+        {
+            if (elements.empty())
+            {
+                fail(path, "property outside of an element");
+            }
+
+            ply_property property;
+            tokens >> property.type;
+            if (property.type == "list")
+            {
+                property.isList = true;
+                tokens >> property.countType >> property.type;
+            }
+
+            tokens >> property.name;
+            elements.back().properties.push_back(property);
+        }
+        else if (keyword == "end_header")
+        {
+            break;
+        }
+    }
+
+    bool ascii = format == "ascii";
+    bool swapBytes = (format == "binary_big_endian") == (std::endian::native == std::endian::little);
+    if (!ascii && format != "binary_little_endian" && format != "binary_big_endian")
+    {
+        fail(path, "unsupported PLY format " + format);
+    }
+
+    // binary lists can be no longer than the data left in the file
+    std::streamoff dataEnd = 0;
+    if (!ascii)
+    {
+        std::streampos dataStart = in.tellg();
+        in.seekg(0, std::ios::end);
+        dataEnd = in.tellg();
+        in.seekg(dataStart);
+    }
+
+    triangle_mesh mesh;
+    std::vector<std::uint32_t> polygon;
+    for (const auto& element : elements)
+    {
+        if (element.name == "vertex")
+        {
+            mesh.numVertices = element.count;
+        }
+
+        for (std::size_t i = 0; i < element.count; ++i)
+        {
+            std::istringstream tokens;
+            if (ascii)
+            {
+                if (!nextDataLine(in, line))
+                {
+                    fail(path, "truncated " + element.name + " list");
+                }
+
+                tokens.str(line);
+            }
+
+            auto read = [&](const std::string& type)
+            {
+                if (ascii)
+                {
+                    double value = 0;
+                    if (!(tokens >> value))
+                    {
+                        fail(path, "bad " + element.name + " on line: " + line);
+                    }
+
+                    return value;
+                }
+
+                return readBinaryScalar(in, type, swapBytes, path);
+            };
+
+            for (const auto& property : element.properties)
+            {
+                bool indices = element.name == "face" && property.isList
+                    && (property.name == "vertex_indices" || property.name == "vertex_index");
+                std::size_t count = 1;
+                if (property.isList)
+                {
+                    double value = read(property.countType);
+                    std::size_t remaining = ascii ? remainingTokens(tokens)
+                        : static_cast<std::size_t>(dataEnd - in.tellg()) / plyTypeSize(property.type, path);
+                    count = plyInteger(value, remaining, element.name + " list count", path);
+                }
+
+                if (indices)
+                {
+                    polygon.resize(count);
+                }
+
+                for (std::size_t k = 0; k < count; ++k)
+                {
+                    double value = read(property.type);
+                    if (indices)
+                    {
+                        polygon[k] = static_cast<std::uint32_t>(plyInteger(value,
+                            std::numeric_limits<std::uint32_t>::max(), "vertex index", path));
+                    }
+                }
+
+                if (indices)
+                {
+                    addPolygon(mesh, polygon, path);
+                }
+            }
+        }
+    }
+
+    return mesh;
+}
+
+}
+
+bool isMeshFile(const std::filesystem::path& path)
+{
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".obj" || extension == ".off" || extension == ".ply";
+}
+
+triangle_mesh readMesh(const std::filesystem::path& path)
+{
+    std::ifstream in(path, std::ios::binary);
+    if (!in)
+    {
+        fail(path, "cannot open file");
+    }
+
+    std::string extension = path.extension().string();
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+        [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (extension == ".obj")
+    {
+        return readObj(in, path);
+    }
+    else if (extension == ".off")
+    {
+        return readOff(in, path);
+    }
+    else if (extension == ".ply")
+    {
+        return readPly(in, path);
+    }
+
+    fail(path, "unknown mesh format");
+}
+
+std::vector<std::uint32_t> dualGraphEdges(const std::vector<std::uint32_t>& triangles)
+{
+    return dualGraph(triangles);
+}
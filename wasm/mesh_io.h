@@ -0,0 +1,31 @@
+#ifndef MESH_IO_H
+#define MESH_IO_H
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <vector>
+
+// connectivity only, positions are not needed to build the dual graph
+struct triangle_mesh
+{
+    std::size_t numVertices = 0;
+    std::vector<std::uint32_t> triangles;
+
+    std::size_t num_faces() const
+    {
+        return triangles.size() / 3;
+    }
+};
+
+// reads OBJ, OFF and PLY (ascii or binary), fan-triangulating polygons;
+// throws std::runtime_error on unreadable or malformed input
+triangle_mesh readMesh(const std::filesystem::path& path);
+
+bool isMeshFile(const std::filesystem::path& path);
+
+// face adjacency as endpoint pairs back to back, one node per triangle;
+// only manifold edges (shared by exactly two faces) produce a dual edge
+std::vector<std::uint32_t> dualGraphEdges(const std::vector<std::uint32_t>& triangles);
+
+#endif
@@ -0,0 +1,381 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include "edmonds.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Edmonds' search run from many free roots at once. Every vertex a worker looks at
+// is first claimed in a shared owner array; a search that runs into a vertex owned
+// by another worker is rolled back and its root retried next round. Regions never
+// overlap, so the per-vertex search state is shared and each worker augments inside
+// its own region without locks. Roots that keep colliding are finished sequentially.
+template<typename Graph>
+class parallel_edmonds
+{
+    public:
+        using node_type = typename Graph::node_type;
+        static constexpr node_type npos = edmonds<Graph>::npos;
+
+    private:
+        enum : std::uint8_t { unlabeled, even, odd };
+        enum class outcome { augmented, exhausted, conflict };
+
+        struct worker
+        {
+            std::uint32_t id = 0;
+            std::uint32_t stamp = 0;
+            std::vector<node_type> queue;
+            std::vector<node_type> touched;
+            std::vector<node_type> merged;
+            std::vector<node_type> retry;
+            std::size_t augmentations = 0;
+            std::size_t contractions = 0;
+            std::size_t maxDepth = 0;
+            std::size_t queuePeak = 0;
+        };
+
+        const Graph& graph;
+        std::vector<node_type> mate;
+        std::vector<node_type> pred;
+        std::vector<node_type> blossomParent;
+        std::vector<std::uint8_t> label;
+        std::vector<std::uint32_t> visited;
+        std::vector<std::uint32_t> depth;
+        // 0 when free, otherwise the id of the worker whose search holds the vertex
+        std::vector<std::atomic<std::uint32_t>> owner;
+        std::size_t numThreads;
+        std::size_t contractions;
+        std::size_t maxDepth;
+        std::size_t queuePeak;
+
+        bool claim(worker& w, node_type v)
+        {
+            if (owner[v].load(std::memory_order_relaxed) == w.id)
+            {
+                return true;
+            }
+
+            std::uint32_t expected = 0;
+            if (owner[v].compare_exchange_strong(expected, w.id, std::memory_order_acquire, std::memory_order_relaxed))
+            {
+                w.touched.push_back(v);
+                return true;
+            }
+
+            return false;
+        }
+
+        // the search state of a vertex is cleared before it is handed back, so the
+        // next owner always starts from a clean slate
+        void release(worker& w)
+        {
+            for (const auto& v : w.touched)
+            {
+                label[v] = unlabeled;
+                pred[v] = npos;
+                blossomParent[v] = v;
+                visited[v] = 0;
+                depth[v] = 0;
+                owner[v].store(0, std::memory_order_release);
+            }
+
+            w.touched.clear();
+            w.queuePeak = std::max(w.queuePeak, w.queue.size());
+            w.queue.clear();
+        }
+
+        node_type base(node_type v)
+        {
+            node_type root = v;
+            while (blossomParent[root] != root)
+            {
+                root = blossomParent[root];
+            }
+
+            while (blossomParent[v] != root)
+            {
+                node_type next = blossomParent[v];
+                blossomParent[v] = root;
+                v = next;
+            }
+
+            return root;
+        }
+
+        node_type lca(worker& w, node_type a, node_type b)
+        {
+            ++w.stamp;
+            while (true)
+            {
+                if (a != npos)
+                {
+                    if (visited[a] == w.stamp)
+                    {
+                        return a;
+                    }
+
+                    visited[a] = w.stamp;
+                    a = mate[a] == npos ? npos : base(pred[mate[a]]);
+                }
+
+                std::swap(a, b);
+            }
+        }
+
+        void shrink(worker& wk, node_type v, node_type w, node_type b)
+        {
+            while (base(v) != b)
+            {
+                pred[v] = w;
+                w = mate[v];
+                if (label[w] == odd)
+                {
+                    label[w] = even;
+                    wk.queue.push_back(w);
+                }
+
+                wk.merged.push_back(base(v));
+                wk.merged.push_back(base(w));
+                v = pred[w];
+            }
+        }
+
+        void contract(worker& wk, node_type v, node_type w)
+        {
+            ++wk.contractions;
+            node_type b = lca(wk, base(v), base(w));
+            shrink(wk, v, w, b);
+            shrink(wk, w, v, b);
+            std::uint32_t nested = depth[b];
+            for (const auto& x : wk.merged)
+            {
+                nested = std::max(nested, depth[x]);
+                blossomParent[x] = b;
+            }
+
+            depth[b] = nested + 1;
+            wk.maxDepth = std::max<std::size_t>(wk.maxDepth, depth[b]);
+
+            wk.merged.clear();
+        }
+
+        void augmentFrom(node_type v, node_type w)
+        {
+            node_type x = mate[v];
+            mate[v] = w;
+            while (x != npos)
+            {
+                node_type pv = pred[x];
+                node_type next = mate[pv];
+                mate[x] = pv;
+                mate[pv] = x;
+                x = next;
+            }
+        }
+
+        // same search as edmonds::search(), except that every vertex is claimed before
+        // its state is read; a finished search without a path is a frustrated tree
+        // over vertices nobody else could change, so its root can never be augmented
+        outcome search(worker& wk, node_type root)
+        {
+            wk.stamp = 0;
+            if (!claim(wk, root))
+            {
+                return outcome::conflict;
+            }
+
+            if (mate[root] != npos)
+            {
+                release(wk);
+                return outcome::exhausted;
+            }
+
+            label[root] = even;
+            wk.queue.push_back(root);
+            for (std::size_t head = 0; head < wk.queue.size(); ++head)
+            {
+                node_type v = wk.queue[head];
+                for (const auto& w : graph.edges_of_node(v))
+                {
+                    if (!claim(wk, w))
+                    {
+                        release(wk);
+                        return outcome::conflict;
+                    }
+
+                    if (label[w] == odd || base(v) == base(w))
+                    {
+                        continue;
+                    }
+
+                    if (label[w] == unlabeled)
+                    {
+                        pred[w] = v;
+                        if (mate[w] == npos)
+                        {
+                            augmentFrom(v, w);
+                            mate[w] = v;
+                            release(wk);
+                            return outcome::augmented;
+                        }
+
+                        label[w] = odd;
+                        node_type x = mate[w];
+                        if (!claim(wk, x))
+                        {
+                            release(wk);
+                            return outcome::conflict;
+                        }
+
+                        label[x] = even;
+                        wk.queue.push_back(x);
+                    }
+                    else
+                    {
+                        contract(wk, v, w);
+                    }
+                }
+            }
+
+            release(wk);
+            return outcome::exhausted;
+        }
+
+    public:
+        // threads == 0 picks the hardware concurrency
+        parallel_edmonds(const Graph& g, std::vector<node_type> initialMates, std::size_t threads = 0): graph(g),
+            mate(std::move(initialMates)), pred(g.num_nodes(), npos), blossomParent(g.num_nodes()),
+            label(g.num_nodes(), unlabeled), visited(g.num_nodes(), 0), depth(g.num_nodes(), 0),
+            owner(g.num_nodes()), numThreads(threads != 0 ? threads : std::max(1u, std::thread::hardware_concurrency())),
+            contractions(0), maxDepth(0), queuePeak(0)
+        {
+            mate.resize(g.num_nodes(), npos);
+            for (std::size_t v = 0; v < blossomParent.size(); ++v)
+            {
+                blossomParent[v] = static_cast<node_type>(v);
+            }
+        }
+
+        parallel_edmonds(const parallel_edmonds&) = delete;
+        parallel_edmonds& operator=(const parallel_edmonds&) = delete;
+
+        // rounds of concurrent searches over the free roots, each worker taking a
+        // contiguous slice so that workers start far apart on meshes with coherent
+        // face ids; once most roots collide the rest is left to a sequential pass
+        std::size_t run()
+        {
+            std::vector<node_type> pending;
+            for (std::size_t v = 0; v < mate.size(); ++v)
+            {
+                node_type root = static_cast<node_type>(v);
+                if (mate[root] == npos && graph.degree(root) != 0)
+                {
+                    pending.push_back(root);
+                }
+            }
+
+            std::vector<worker> workers(numThreads);
+            for (std::size_t k = 0; k < workers.size(); ++k)
+            {
+                workers[k].id = static_cast<std::uint32_t>(k + 1);
+            }
+
+            while (pending.size() > workers.size())
+            {
+                auto work = [this, &pending](worker& wk, std::size_t begin, std::size_t end)
+                {
+                    for (std::size_t i = begin; i < end; ++i)
+                    {
+                        switch (search(wk, pending[i]))
+                        {
+                            case outcome::augmented: ++wk.augmentations; break;
+                            case outcome::conflict: wk.retry.push_back(pending[i]); break;
+                            case outcome::exhausted: break;
+                        }
+                    }
+                };
+
+                std::vector<std::thread> threads;
+                std::size_t slice = (pending.size() + workers.size() - 1) / workers.size();
+                for (std::size_t k = 1; k < workers.size(); ++k)
+                {
+                    std::size_t begin = std::min(pending.size(), k * slice);
+                    threads.emplace_back(work, std::ref(workers[k]), begin, std::min(pending.size(), begin + slice));
+                }
+
+                work(workers[0], 0, std::min(pending.size(), slice));
+                for (auto& t : threads)
+                {
+                    t.join();
+                }
+
+                std::size_t attempted = pending.size();
+                pending.clear();
+                for (auto& wk : workers)
+                {
+                    pending.insert(pending.end(), wk.retry.begin(), wk.retry.end());
+                    wk.retry.clear();
+                }
+
+                if (pending.size() * 2 > attempted)
+                {
+                    break;
+                }
+            }
+
+            std::size_t augmentations = 0;
+            for (const auto& wk : workers)
+            {
+                augmentations += wk.augmentations;
+                contractions += wk.contractions;
+                maxDepth = std::max(maxDepth, wk.maxDepth);
+                queuePeak = std::max(queuePeak, wk.queuePeak);
+            }
+
+            edmonds<Graph> finisher(graph, std::move(mate));
+            for (const auto& root : pending)
+            {
+                if (finisher.mates()[root] == npos && finisher.search(root))
+                {
+                    ++augmentations;
+                }
+            }
+
+            mate = finisher.mates();
+            contractions += finisher.num_contractions();
+            maxDepth = std::max(maxDepth, finisher.max_depth());
+            queuePeak = std::max(queuePeak, finisher.queue_peak());
+            return augmentations;
+        }
+
+        std::size_t num_contractions() const
+        {
+            return contractions;
+        }
+
+        std::size_t max_depth() const
+        {
+            return maxDepth;
+        }
+
+        // the longest single search queue of any worker or the finisher
+        std::size_t queue_peak() const
+        {
+            return queuePeak;
+        }
+
+        const std::vector<node_type>& mates() const
+        {
+            return mate;
+        }
+};
+
+#endif
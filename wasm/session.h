@@ -0,0 +1,490 @@
+#ifndef SESSION_H
+#define SESSION_H
+
+#include "adjacency_graph.h"
+#include "csr_graph.h"
+#include "edmonds.h"
+#include "greedy.h"
+#include "link_cut.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+// keeps the matching and cycle structure of a dual graph alive across edits, so
+// that a batch of added and removed edges is repaired with a few local searches
+// instead of solving the whole mesh again
+template<typename T = std::uint32_t>
+class matching_session
+{
+    public:
+        using node_type = T;
+        static constexpr T npos = std::numeric_limits<T>::max();
+
+    private:
+        adjacency_graph<T> graph;
+        edmonds<adjacency_graph<T>> matcher;
+        // free vertices with edges, every search from them has failed so far
+        std::vector<T> unmatched;
+        // vertices whose edges or mate changed since the last repair
+        std::vector<T> dirty;
+        std::vector<std::uint8_t> isDirty;
+        std::vector<T> flips;
+        // component of the matching's complement each vertex lies on, ids are recycled
+        std::vector<T> cycleOf;
+        std::vector<T> freeIds;
+        std::vector<std::uint8_t> staleId;
+        T numIds;
+        std::vector<T> area;
+        std::vector<std::uint8_t> inArea;
+        // matched edges subdivided to merge two cycles; as edges between cycle ids they
+        // form a forest, so replayed in any order each joins two different cycles,
+        // which is all hamiltonian_cycle() needs
+        std::vector<std::pair<T, T>> joins;
+        // index into joins of the join each vertex is an end of
+        std::vector<T> joinAt;
+        link_cut_forest<T> joinForest;
+        // per cycle id while relinking, the tree of joinForest it was in, merged from
+        // there like union-find; npos when not looked up
+        std::vector<T> treeOf;
+        std::size_t augmentations;
+
+        void markDirty(T v)
+        {
+            if (!isDirty[v])
+            {
+                isDirty[v] = 1;
+                dirty.push_back(v);
+            }
+        }
+
+        std::size_t complementDegree(T v) const
+        {
+            return graph.degree(v) - (matcher.mates()[v] != npos);
+        }
+
+        void resize(std::size_t n)
+        {
+            graph.resize(n);
+            matcher.resize(n);
+            isDirty.resize(n, 0);
+            cycleOf.resize(n, npos);
+            inArea.resize(n, 0);
+            joinAt.resize(n, npos);
+        }
+
+        void dropEdge(T v, T w)
+        {
+            if (graph.remove_edge(v, w))
+            {
+                if (matcher.mates()[v] == w)
+                {
+                    matcher.unmatch(v);
+                }
+
+                markDirty(v);
+                markDirty(w);
+            }
+        }
+
+        // an augmenting path after the edit has to end at a vertex freed by it or use an
+        // added edge; without added edges only the freed vertices need a search, unless
+        // one of them augments: a path between two freed vertices can leave one between
+        // vertices that were free all along. A root that fails stays failed, so one
+        // pass over both lists is enough
+        std::size_t repairMatching(bool grew)
+        {
+            const auto& mate = matcher.mates();
+            auto searchFrom = [&](const std::vector<T>& roots)
+            {
+                std::size_t found = 0;
+                for (const auto& root : roots)
+                {
+                    if (mate[root] == npos && graph.degree(root) != 0 && matcher.search(root))
+                    {
+                        ++found;
+                    }
+                }
+
+                return found;
+            };
+
+            matcher.log_flips(&flips);
+            std::size_t found = searchFrom(dirty);
+            if (grew || found != 0)
+            {
+                found += searchFrom(unmatched);
+            }
+
+            matcher.log_flips(nullptr);
+            for (const auto& v : flips)
+            {
+                markDirty(v);
+            }
+
+            flips.clear();
+            std::vector<T> stillFree;
+            for (const auto& v : unmatched)
+            {
+                if (!isDirty[v] && mate[v] == npos && graph.degree(v) != 0)
+                {
+                    stillFree.push_back(v);
+                }
+            }
+
+            for (const auto& v : dirty)
+            {
+                if (mate[v] == npos && graph.degree(v) != 0)
+                {
+                    stillFree.push_back(v);
+                }
+            }
+
+            unmatched = std::move(stillFree);
+            return found;
+        }
+
+        T newId()
+        {
+            if (freeIds.empty())
+            {
+                staleId.push_back(0);
+                treeOf.push_back(npos);
+                joinForest.resize(numIds + std::size_t{1});
+                return numIds++;
+            }
+
+            T id = freeIds.back();
+            freeIds.pop_back();
+            return id;
+        }
+
+        void addJoin(T v, T w)
+        {
+            joinForest.link(cycleOf[v], cycleOf[w]);
+            joinAt[v] = joinAt[w] = static_cast<T>(joins.size());
+            joins.emplace_back(v, w);
+        }
+
+        void removeJoin(T k)
+        {
+            auto [v, w] = joins[k];
+            joinForest.cut(cycleOf[v], cycleOf[w]);
+            joinAt[v] = joinAt[w] = npos;
+            if (k + std::size_t{1} != joins.size())
+            {
+                joins[k] = joins.back();
+                joinAt[joins[k].first] = joinAt[joins[k].second] = k;
+            }
+
+            joins.pop_back();
+        }
+
+        // edges only change at dirty vertices, so walking the complement from them
+        // reaches every vertex of every cycle that went through one, before the edit
+        // or after. Only joins with an end in that area are cut and the rebuilt cycles
+        // relinked, the rest of the join forest stays as it was
+        void repairCycles()
+        {
+            const auto& mate = matcher.mates();
+            // ids of the old cycles are only free for reuse once the walk has cut all of
+            // their joins; a join is cut at whichever end comes first, while the other
+            // end still has its old id
+            std::vector<T> freed;
+            std::vector<T> stack;
+            for (const auto& seed : dirty)
+            {
+                if (inArea[seed])
+                {
+                    continue;
+                }
+
+                inArea[seed] = 1;
+                area.push_back(seed);
+                T id = graph.degree(seed) == 0 ? npos : newId();
+                stack.push_back(seed);
+                while (!stack.empty())
+                {
+                    T v = stack.back();
+                    stack.pop_back();
+                    if (joinAt[v] != npos)
+                    {
+                        removeJoin(joinAt[v]);
+                    }
+
+                    if (cycleOf[v] != npos && !staleId[cycleOf[v]])
+                    {
+                        staleId[cycleOf[v]] = 1;
+                        freed.push_back(cycleOf[v]);
+                    }
+
+                    cycleOf[v] = id;
+                    for (const auto& w : graph.edges_of_node(v))
+                    {
+                        if (w != mate[v] && !inArea[w])
+                        {
+                            inArea[w] = 1;
+                            area.push_back(w);
+                            stack.push_back(w);
+                        }
+                    }
+                }
+            }
+
+            for (const auto& id : freed)
+            {
+                staleId[id] = 0;
+                freeIds.push_back(id);
+            }
+
+            // the forest only gains edges from here on, so each cycle's tree is looked
+            // up once and the links made since are followed in treeOf
+            std::vector<T> looked;
+            auto tree = [&](T id)
+            {
+                if (treeOf[id] == npos)
+                {
+                    T root = joinForest.root(id);
+                    for (T x : {root, id})
+                    {
+                        if (treeOf[x] == npos)
+                        {
+                            treeOf[x] = root;
+                            looked.push_back(x);
+                        }
+                    }
+                }
+
+                while (treeOf[id] != id)
+                {
+                    treeOf[id] = treeOf[treeOf[id]];
+                    id = treeOf[id];
+                }
+
+                return id;
+            };
+
+            for (const auto& v : area)
+            {
+                T w = mate[v];
+                if (w == npos || joinAt[v] != npos || complementDegree(v) != 2 || complementDegree(w) != 2)
+                {
+                    continue;
+                }
+
+                T tree1 = tree(cycleOf[v]);
+                T tree2 = tree(cycleOf[w]);
+                if (tree1 != tree2)
+                {
+                    treeOf[tree1] = tree2;
+                    addJoin(v, w);
+                }
+            }
+
+            for (const auto& id : looked)
+            {
+                treeOf[id] = npos;
+            }
+
+            for (const auto& v : area)
+            {
+                inArea[v] = 0;
+            }
+
+            for (const auto& v : dirty)
+            {
+                isDirty[v] = 0;
+            }
+
+            area.clear();
+            dirty.clear();
+        }
+
+    public:
+        explicit matching_session(const csr_graph<T>& initial): graph(initial), matcher(graph, greedyMatching(initial)),
+            unmatched(), dirty(), isDirty(graph.num_nodes(), 0), flips(), cycleOf(graph.num_nodes(), npos), freeIds(),
+            staleId(), numIds(0), area(), inArea(graph.num_nodes(), 0), joins(), joinAt(graph.num_nodes(), npos),
+            joinForest(), treeOf(), augmentations(0)
+        {
+            augmentations = matcher.run();
+            for (std::size_t v = 0; v < graph.num_nodes(); ++v)
+            {
+                T node = static_cast<T>(v);
+                if (matcher.mates()[node] == npos && graph.degree(node) != 0)
+                {
+                    unmatched.push_back(node);
+                }
+
+                markDirty(node);
+            }
+
+            repairCycles();
+        }
+
+        // edgeNums holds endpoint pairs back to back, as passed in from JS
+        explicit matching_session(std::span<const T> edgeNums): matching_session(csr_graph<T>(edgeNums)) {}
+
+        matching_session(const matching_session&) = delete;
+        matching_session& operator=(const matching_session&) = delete;
+
+        // apply one edit batch and repair; node ids past the current bound are added by
+        // naming them in addedEdges, removing a node drops all of its edges
+        std::size_t update(std::span<const T> addedEdges, std::span<const T> removedEdges,
+                std::span<const T> removedNodes = {})
+        {
+            for (std::size_t i = 0; i + 1 < removedEdges.size(); i += 2)
+            {
+                dropEdge(removedEdges[i], removedEdges[i + 1]);
+            }
+
+            for (const auto& v : removedNodes)
+            {
+                while (graph.degree(v) != 0)
+                {
+                    dropEdge(v, graph.edges_of_node(v).back());
+                }
+            }
+
+            std::size_t bound = graph.num_nodes();
+            for (const auto& v : addedEdges)
+            {
+                bound = std::max(bound, static_cast<std::size_t>(v) + 1);
+            }
+
+            resize(bound);
+            bool grew = false;
+            for (std::size_t i = 0; i + 1 < addedEdges.size(); i += 2)
+            {
+                if (graph.add_edge(addedEdges[i], addedEdges[i + 1]))
+                {
+                    grew = true;
+                    markDirty(addedEdges[i]);
+                    markDirty(addedEdges[i + 1]);
+                }
+            }
+
+            augmentations = repairMatching(grew);
+            repairCycles();
+            return augmentations;
+        }
+
+        // augmenting paths found by the most recent construction or update
+        std::size_t last_augmentations() const
+        {
+            return augmentations;
+        }
+
+        std::size_t size() const
+        {
+            return matcher.size();
+        }
+
+        std::size_t num_nodes() const
+        {
+            return graph.num_nodes();
+        }
+
+        // matched edges as endpoint pairs back to back
+        std::vector<T> matching() const
+        {
+            const auto& mate = matcher.mates();
+            std::vector<T> edgeNums;
+            for (std::size_t v = 0; v < mate.size(); ++v)
+            {
+                if (mate[v] != npos && v < mate[v])
+                {
+                    edgeNums.push_back(static_cast<T>(v));
+                    edgeNums.push_back(mate[v]);
+                }
+            }
+
+            return edgeNums;
+        }
+
+        // same layout as hamiltonianCycle(): the cycle's edges, then (node, twin,
+        // matched neighbor, its twin) for every subdivided matched edge
+        std::pair<std::vector<T>, std::vector<T>> hamiltonian_cycle() const
+        {
+            const auto& mate = matcher.mates();
+            std::size_t n = graph.num_nodes();
+            std::size_t total = n + 2 * joins.size();
+
+            // the matching's complement in CSR form, twins get two slots each
+            std::vector<std::size_t> offsets(total + 1, 0);
+            for (std::size_t v = 0; v < n; ++v)
+            {
+                offsets[v + 1] = offsets[v] + complementDegree(static_cast<T>(v));
+            }
+
+            for (std::size_t v = n; v < total; ++v)
+            {
+                offsets[v + 1] = offsets[v] + 2;
+            }
+
+            std::vector<T> ring(offsets.back());
+            for (std::size_t v = 0; v < n; ++v)
+            {
+                std::size_t k = offsets[v];
+                for (const auto& w : graph.edges_of_node(static_cast<T>(v)))
+                {
+                    if (w != mate[v])
+                    {
+                        ring[k++] = w;
+                    }
+                }
+            }
+
+            auto replace = [&](T v, T from, T to)
+            {
+                auto first = ring.begin() + static_cast<std::ptrdiff_t>(offsets[v]);
+                auto last = ring.begin() + static_cast<std::ptrdiff_t>(offsets[v + 1]);
+                *std::find(first, last, from) = to;
+            };
+
+            std::vector<T> subdivisions;
+            subdivisions.reserve(4 * joins.size());
+            T next = static_cast<T>(n);
+            for (const auto& [v1, v2] : joins)
+            {
+                T twin1 = next++;
+                T twin2 = next++;
+                T other1 = ring[offsets[v1] + 1];
+                T other2 = ring[offsets[v2] + 1];
+                ring[offsets[v1] + 1] = v2;
+                ring[offsets[v2] + 1] = v1;
+                replace(other1, v1, twin1);
+                replace(other2, v2, twin2);
+                ring[offsets[twin1]] = other1;
+                ring[offsets[twin1] + 1] = twin2;
+                ring[offsets[twin2]] = other2;
+                ring[offsets[twin2] + 1] = twin1;
+
+                subdivisions.push_back(v1);
+                subdivisions.push_back(twin1);
+                subdivisions.push_back(v2);
+                subdivisions.push_back(twin2);
+            }
+
+            std::vector<T> edgeNums;
+            edgeNums.reserve(ring.size());
+            for (std::size_t v = 0; v < total; ++v)
+            {
+                for (std::size_t k = offsets[v]; k < offsets[v + 1]; ++k)
+                {
+                    if (v < ring[k])
+                    {
+                        edgeNums.push_back(static_cast<T>(v));
+                        edgeNums.push_back(ring[k]);
+                    }
+                }
+            }
+
+            return {edgeNums, subdivisions};
+        }
+};
+
+#endif
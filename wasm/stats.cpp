@@ -0,0 +1,182 @@
+#include "stats.h"
+
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace
+{
+
+struct trace_event
+{
+    const char* name;
+    double start;
+    double duration;
+};
+
+using clock_type = std::chrono::steady_clock;
+
+// one epoch for every thread so their events line up on a single timeline
+const clock_type::time_point epoch = clock_type::now();
+std::atomic<std::uint32_t> nextThreadId{1};
+
+thread_local solve_stats currentStats;
+// how many timers of each phase are running, a recursive phase only counts its outermost call
+thread_local std::vector<std::size_t> activeTimers;
+thread_local std::size_t openScopes = 0;
+thread_local std::size_t allocationCount = 0;
+thread_local std::size_t allocationBytes = 0;
+thread_local bool tracing = false;
+thread_local std::vector<trace_event> traceEvents;
+
+double microseconds(clock_type::time_point t)
+{
+    return std::chrono::duration<double, std::micro>(t - epoch).count();
+}
+
+void addEvent(const char* name, clock_type::time_point start, clock_type::time_point end)
+{
+    if (tracing)
+    {
+        traceEvents.push_back({name, microseconds(start), microseconds(end) - microseconds(start)});
+    }
+}
+
+}
+
+const solve_stats& lastSolveStats()
+{
+    return currentStats;
+}
+
+solve_stats& currentSolveStats()
+{
+    return currentStats;
+}
+
+void countAllocation(std::size_t bytes)
+{
+    ++allocationCount;
+    allocationBytes += bytes;
+}
+
+void setTracing(bool enabled)
+{
+    tracing = enabled;
+    traceEvents.clear();
+}
+
+std::string traceJson()
+{
+    thread_local const std::uint32_t threadId = nextThreadId++;
+    std::ostringstream out;
+    out.precision(3);
+    out << std::fixed << "{\"traceEvents\":[";
+    for (std::size_t i = 0; i < traceEvents.size(); ++i)
+    {
+        const auto& e = traceEvents[i];
+        out << (i == 0 ? "" : ",") << "\n{\"name\":\"" << e.name << "\",\"cat\":\"blossom\",\"ph\":\"X\",\"ts\":"
+            << e.start << ",\"dur\":" << e.duration << ",\"pid\":1,\"tid\":" << threadId << "}";
+    }
+
+    out << "\n]}\n";
+    return out.str();
+}
+
+solve_scope::solve_scope(const char* entryPoint): name(entryPoint), start(clock_type::now()),
+    allocations(allocationCount), bytes(allocationBytes), outermost(openScopes++ == 0)
+{
+    if (outermost)
+    {
+        currentStats = solve_stats{};
+        activeTimers.clear();
+    }
+}
+
+solve_scope::~solve_scope()
+{
+    auto end = clock_type::now();
+    --openScopes;
+    addEvent(name, start, end);
+    if (outermost)
+    {
+        currentStats.totalMilliseconds = std::chrono::duration<double, std::milli>(end - start).count();
+        currentStats.allocations = allocationCount - allocations;
+        currentStats.allocatedBytes = allocationBytes - bytes;
+    }
+}
+
+phase_timer::phase_timer(const char* phaseName): name(phaseName), phase(0), start(clock_type::now())
+{
+    auto& phases = currentStats.phases;
+    while (phase < phases.size() && phases[phase].name != name)
+    {
+        ++phase;
+    }
+
+    if (phase == phases.size())
+    {
+        phases.push_back({name, 0, 0});
+    }
+
+    activeTimers.resize(phases.size(), 0);
+    ++phases[phase].calls;
+    ++activeTimers[phase];
+}
+
+phase_timer::~phase_timer()
+{
+    auto end = clock_type::now();
+    addEvent(name, start, end);
+    // a solve_scope opened while the timer ran has reset the phases
+    if (phase < activeTimers.size() && --activeTimers[phase] == 0)
+    {
+        currentStats.phases[phase].milliseconds += std::chrono::duration<double, std::milli>(end - start).count();
+    }
+}
+
+#ifdef BLOSSOM_ALLOCATION_STATS
+
+// builds without a heap profiler of their own (the wasm module) count through the
+// global allocator; programs that replace operator new call countAllocation() instead
+void* operator new(std::size_t size)
+{
+    void* ptr = std::malloc(size == 0 ? 1 : size);
+    if (ptr == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    countAllocation(size);
+    return ptr;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete[](void* ptr, std::size_t) noexcept
+{
+    std::free(ptr);
+}
+
+#endif
@@ -0,0 +1,51 @@
+#ifndef STATS_H
+#define STATS_H
+
+#include "blossom.h"
+
+#include <chrono>
+#include <cstddef>
+
+// the stats of the solve running on this thread, reset by the outermost solve_scope
+solve_stats& currentSolveStats();
+
+// called by operator new replacements, the library's own (BLOSSOM_ALLOCATION_STATS)
+// or an embedding program's, so allocations can be attributed to a solve
+void countAllocation(std::size_t bytes);
+
+// wraps one public entry point: resets the stats, measures total time and
+// allocations, and adds a trace event; nested scopes only add the event
+class solve_scope
+{
+    const char* name;
+    std::chrono::steady_clock::time_point start;
+    std::size_t allocations;
+    std::size_t bytes;
+    bool outermost;
+
+    public:
+        explicit solve_scope(const char* entryPoint);
+        ~solve_scope();
+
+        solve_scope(const solve_scope&) = delete;
+        solve_scope& operator=(const solve_scope&) = delete;
+};
+
+// accumulates wall time into the phase of that name; a phase re-entered while
+// active (recursion) counts the call but not the time twice. Names must be
+// string literals, trace events keep the pointer
+class phase_timer
+{
+    const char* name;
+    std::size_t phase;
+    std::chrono::steady_clock::time_point start;
+
+    public:
+        explicit phase_timer(const char* phaseName);
+        ~phase_timer();
+
+        phase_timer(const phase_timer&) = delete;
+        phase_timer& operator=(const phase_timer&) = delete;
+};
+
+#endif
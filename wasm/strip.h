@@ -0,0 +1,389 @@
+#ifndef STRIP_H
+#define STRIP_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <vector>
+
+// walks an edge list of degree <= 2 nodes into node order, paths first and then
+// cycles, each from its smallest node; a node of higher degree continues along its
+// first unvisited neighbor, so broken input still yields every node exactly once
+template<typename T>
+std::vector<T> cycleOrder(std::span<const T> cycleEdges)
+{
+    std::size_t bound = 0;
+    for (const auto& v : cycleEdges)
+    {
+        bound = std::max(bound, static_cast<std::size_t>(v) + 1);
+    }
+
+    std::vector<std::size_t> offsets(bound + 1, 0);
+    for (const auto& v : cycleEdges)
+    {
+        ++offsets[v + 1];
+    }
+
+    for (std::size_t v = 1; v < offsets.size(); ++v)
+    {
+        offsets[v] += offsets[v - 1];
+    }
+
+    std::vector<T> adjacency(cycleEdges.size());
+    std::vector<std::size_t> fill(offsets.cbegin(), offsets.cend() - 1);
+    for (std::size_t i = 0; i + 1 < cycleEdges.size(); i += 2)
+    {
+        adjacency[fill[cycleEdges[i]]++] = cycleEdges[i + 1];
+        adjacency[fill[cycleEdges[i + 1]]++] = cycleEdges[i];
+    }
+
+    std::vector<T> order;
+    std::vector<std::uint8_t> visited(bound, 0);
+    auto walk = [&](std::size_t start)
+    {
+        std::size_t v = start;
+        while (true)
+        {
+            visited[v] = 1;
+            order.push_back(static_cast<T>(v));
+            std::size_t next = bound;
+            for (std::size_t k = offsets[v]; k < offsets[v + 1] && next == bound; ++k)
+            {
+                if (!visited[adjacency[k]])
+                {
+                    next = adjacency[k];
+                }
+            }
+
+            if (next == bound)
+            {
+                return;
+            }
+
+            v = next;
+        }
+    };
+
+    for (std::size_t v = 0; v < bound; ++v)
+    {
+        if (!visited[v] && offsets[v + 1] - offsets[v] == 1)
+        {
+            walk(v);
+        }
+    }
+
+    for (std::size_t v = 0; v < bound; ++v)
+    {
+        if (!visited[v] && offsets[v + 1] != offsets[v])
+        {
+            walk(v);
+        }
+    }
+
+    return order;
+}
+
+// Appends the nodes below numNodes that order leaves out. A node without cycle
+// edges is isolated or matched to a node of degree one, so each such node, next to
+// a partner that is left out as well when it has one, becomes a run of its own.
+template<typename T>
+void appendUncovered(std::vector<T>& order, std::size_t numNodes, std::span<const T> edgeNums)
+{
+    constexpr T npos = std::numeric_limits<T>::max();
+    std::vector<std::uint8_t> placed(numNodes, 0);
+    for (const auto& v : order)
+    {
+        if (v < numNodes)
+        {
+            placed[v] = 1;
+        }
+    }
+
+    std::vector<T> partner(numNodes, npos);
+    for (std::size_t i = 0; i + 1 < edgeNums.size(); i += 2)
+    {
+        T v = edgeNums[i];
+        T w = edgeNums[i + 1];
+        if (v != w && v < numNodes && w < numNodes && !placed[v] && !placed[w]
+            && partner[v] == npos && partner[w] == npos)
+        {
+            partner[v] = w;
+            partner[w] = v;
+        }
+    }
+
+    for (std::size_t v = 0; v < numNodes; ++v)
+    {
+        if (placed[v])
+        {
+            continue;
+        }
+
+        order.push_back(static_cast<T>(v));
+        placed[v] = 1;
+        if (partner[v] != npos)
+        {
+            order.push_back(partner[v]);
+            placed[partner[v]] = 1;
+        }
+    }
+}
+
+// Gives every cycle node its own triangle. Each subdivision (node, twin, matched
+// neighbor, its twin) splits the two faces at a new vertex on their shared edge,
+// numbered after the input vertices, with the endpoints appended to midpoints.
+// The halves are assigned from each node's neighbor outside the subdivision, and
+// the edges across the split edge are rewired so that consecutive cycle nodes
+// always share a mesh edge; any such wiring is still a single cycle.
+template<typename T>
+std::vector<T> splitSubdivided(std::span<const T> triangles, std::span<const T> subdivisions,
+        std::vector<T>& cycleEdges, std::vector<T>& midpoints)
+{
+    constexpr T npos = std::numeric_limits<T>::max();
+    std::size_t numFaces = triangles.size() / 3;
+    std::size_t total = numFaces + subdivisions.size() / 2;
+    T numVertices = 0;
+    for (const auto& v : triangles)
+    {
+        numVertices = std::max(numVertices, static_cast<T>(v + 1));
+    }
+
+    std::vector<T> nodeTriangles(3 * total);
+    std::copy(triangles.begin(), triangles.begin() + static_cast<std::ptrdiff_t>(3 * numFaces), nodeTriangles.begin());
+    std::vector<T> original(total);
+    for (std::size_t v = 0; v < total; ++v)
+    {
+        original[v] = static_cast<T>(v);
+    }
+
+    for (std::size_t i = 0; i + 3 < subdivisions.size(); i += 4)
+    {
+        for (std::size_t k : {std::size_t{1}, std::size_t{3}})
+        {
+            if (subdivisions[i + k] < total && subdivisions[i + k - 1] < numFaces)
+            {
+                original[subdivisions[i + k]] = subdivisions[i + k - 1];
+            }
+        }
+    }
+
+    // two slots per node, degree above two means the input was not a cycle cover
+    std::vector<T> ring(2 * total, npos);
+    bool simple = true;
+    for (std::size_t i = 0; i + 1 < cycleEdges.size() && simple; i += 2)
+    {
+        for (auto [v, w] : {std::array<T, 2>{cycleEdges[i], cycleEdges[i + 1]}, std::array<T, 2>{cycleEdges[i + 1], cycleEdges[i]}})
+        {
+            if (v >= total)
+            {
+                simple = false;
+            }
+            else if (ring[2 * v] == npos)
+            {
+                ring[2 * v] = w;
+            }
+            else if (ring[2 * v + 1] == npos)
+            {
+                ring[2 * v + 1] = w;
+            }
+            else
+            {
+                simple = false;
+            }
+        }
+    }
+
+    auto face = [&](T v) { return triangles.subspan(3 * static_cast<std::size_t>(original[v]), 3); };
+    auto hasVertex = [&](T v, T x)
+    {
+        auto f = face(v);
+        return f[0] == x || f[1] == x || f[2] == x;
+    };
+
+    for (std::size_t i = 0; i + 3 < subdivisions.size(); i += 4)
+    {
+        T v1 = subdivisions[i];
+        T twin1 = subdivisions[i + 1];
+        T v2 = subdivisions[i + 2];
+        T twin2 = subdivisions[i + 3];
+        if (std::max({v1, v2}) >= numFaces || std::max({twin1, twin2}) >= total)
+        {
+            continue;
+        }
+
+        // orient the split edge as it runs in v1, a to b, with c opposite; in v2 it runs b to a
+        auto f1 = face(v1);
+        std::size_t r = 0;
+        while (r < 3 && !(hasVertex(v2, f1[r]) && hasVertex(v2, f1[(r + 1) % 3])))
+        {
+            ++r;
+        }
+
+        T m = static_cast<T>(numVertices + midpoints.size() / 2);
+        if (r == 3)
+        {
+            std::copy(f1.begin(), f1.end(), nodeTriangles.begin() + 3 * twin1);
+            auto f2 = face(v2);
+            std::copy(f2.begin(), f2.end(), nodeTriangles.begin() + 3 * twin2);
+            midpoints.push_back(f1[0]);
+            midpoints.push_back(f1[0]);
+            continue;
+        }
+
+        T a = f1[r];
+        T b = f1[(r + 1) % 3];
+        T c = f1[(r + 2) % 3];
+        auto f2 = face(v2);
+        T d = f2[0] != a && f2[0] != b ? f2[0] : (f2[1] != a && f2[1] != b ? f2[1] : f2[2]);
+        midpoints.push_back(a);
+        midpoints.push_back(b);
+
+        // the half of each pair that keeps the side through b, by its outside neighbor
+        auto outside = [&](T v, T other1, T other2)
+        {
+            T w = ring[2 * v];
+            return w == other1 || w == other2 ? ring[2 * v + 1] : w;
+        };
+
+        T bSide1 = v1;
+        T bSide2 = v2;
+        if (simple)
+        {
+            T out1 = outside(v1, v2, twin2);
+            T out2 = outside(v2, v1, twin1);
+            bSide1 = out1 != npos && hasVertex(out1, b) ? v1 : twin1;
+            bSide2 = out2 != npos && hasVertex(out2, b) ? v2 : twin2;
+        }
+
+        T aSide1 = bSide1 == v1 ? twin1 : v1;
+        T aSide2 = bSide2 == v2 ? twin2 : v2;
+        std::array<T, 3> halves[] = {{m, b, c}, {a, m, c}, {b, m, d}, {m, a, d}};
+        std::copy(halves[0].begin(), halves[0].end(), nodeTriangles.begin() + 3 * bSide1);
+        std::copy(halves[1].begin(), halves[1].end(), nodeTriangles.begin() + 3 * aSide1);
+        std::copy(halves[2].begin(), halves[2].end(), nodeTriangles.begin() + 3 * bSide2);
+        std::copy(halves[3].begin(), halves[3].end(), nodeTriangles.begin() + 3 * aSide2);
+
+        if (simple)
+        {
+            for (T v : {v1, twin1})
+            {
+                for (std::size_t k = 2 * v; k < 2 * v + 2; ++k)
+                {
+                    if (ring[k] == v2 || ring[k] == twin2)
+                    {
+                        ring[k] = v == bSide1 ? bSide2 : aSide2;
+                    }
+                }
+            }
+
+            for (T v : {v2, twin2})
+            {
+                for (std::size_t k = 2 * v; k < 2 * v + 2; ++k)
+                {
+                    if (ring[k] == v1 || ring[k] == twin1)
+                    {
+                        ring[k] = v == bSide2 ? bSide1 : aSide1;
+                    }
+                }
+            }
+        }
+    }
+
+    if (simple)
+    {
+        cycleEdges.clear();
+        for (std::size_t k = 0; k < ring.size(); ++k)
+        {
+            if (ring[k] != npos && k / 2 < ring[k])
+            {
+                cycleEdges.push_back(static_cast<T>(k / 2));
+                cycleEdges.push_back(ring[k]);
+            }
+        }
+    }
+
+    return nodeTriangles;
+}
+
+// One strip through the triangles of the nodes in order. A triangle that shares the
+// strip's last edge costs one index; one that shares the other edge of the previous
+// triangle costs a swap, two extra indices and two degenerate triangles; anything
+// else restarts with degenerates, padded so every triangle keeps its winding.
+template<typename T>
+std::vector<T> stripFromOrder(std::span<const T> nodeTriangles, std::span<const T> order)
+{
+    auto triangle = [&](T v)
+    {
+        auto first = nodeTriangles.begin() + 3 * static_cast<std::ptrdiff_t>(v);
+        return std::array<T, 3>{first[0], first[1], first[2]};
+    };
+
+    auto contains = [](const std::array<T, 3>& t, T x)
+    {
+        return t[0] == x || t[1] == x || t[2] == x;
+    };
+
+    std::vector<T> strip;
+    strip.reserve(order.size() + 2);
+    for (std::size_t i = 0; i < order.size(); ++i)
+    {
+        auto t = triangle(order[i]);
+        if (i > 0 && strip.size() >= 3)
+        {
+            T o = strip[strip.size() - 3];
+            T p = strip[strip.size() - 2];
+            T q = strip[strip.size() - 1];
+            std::size_t shared = contains(t, o) + contains(t, p) + contains(t, q);
+            T w = !contains({o, p, q}, t[0]) ? t[0] : (!contains({o, p, q}, t[1]) ? t[1] : t[2]);
+            if (shared == 2 && contains(t, p) && contains(t, q))
+            {
+                strip.push_back(w);
+                continue;
+            }
+
+            if (shared == 2 && contains(t, o) && contains(t, q))
+            {
+                strip.push_back(q);
+                strip.push_back(o);
+                strip.push_back(w);
+                continue;
+            }
+        }
+
+        // start a new run, rotated so the edge shared with the next triangle comes last
+        std::size_t k = 0;
+        if (i + 1 < order.size())
+        {
+            auto next = triangle(order[i + 1]);
+            while (k < 3 && !(contains(next, t[(k + 1) % 3]) && contains(next, t[(k + 2) % 3])))
+            {
+                ++k;
+            }
+
+            k %= 3;
+        }
+
+        // the run's first vertex twice, so no triangle spans the gap, and a third time
+        // when the run would otherwise start on an odd index
+        if (!strip.empty())
+        {
+            strip.push_back(strip.back());
+            strip.push_back(t[k]);
+            if (strip.size() % 2 == 1)
+            {
+                strip.push_back(t[k]);
+            }
+        }
+
+        strip.push_back(t[k]);
+        strip.push_back(t[(k + 1) % 3]);
+        strip.push_back(t[(k + 2) % 3]);
+    }
+
+    return strip;
+}
+
+#endif
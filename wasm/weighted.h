@@ -0,0 +1,789 @@
+#ifndef WEIGHTED_H
+#define WEIGHTED_H
+
+#include "csr_graph.h"
+#include "greedy.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <span>
+#include <utility>
+#include <vector>
+
+// Minimum weight matching among the maximum cardinality ones, so a minimum weight
+// perfect matching whenever the graph has a perfect matching. This is Edmonds'
+// primal-dual blossom algorithm in Galil's O(n^3) formulation: weights are turned
+// into a maximum weight problem over integers, and vertex duals are kept doubled so
+// that every slack stays integral. Blossoms are explicit here, with their children in
+// cycle order from the base and the endpoints of the edges between them, because
+// expanding one at a zero dual needs that order.
+//
+// Edges are numbered in input order; endpoint 2k and 2k + 1 are the ends of edge k,
+// so p ^ 1 is the other end of endpoint p. mate holds the remote endpoint.
+template<typename T>
+class weighted_matching
+{
+    public:
+        using node_type = T;
+        using weight_type = std::int64_t;
+        static constexpr node_type npos = std::numeric_limits<node_type>::max();
+
+    private:
+        static constexpr std::size_t none = std::numeric_limits<std::size_t>::max();
+        // breadcrumb marks blossoms on the paths walked by scanBlossom()
+        enum : std::uint8_t { unlabeled = 0, even = 1, odd = 2, breadcrumb = 4 };
+
+        std::size_t numVertices;
+        std::vector<node_type> endpoint;
+        std::vector<weight_type> weight;
+        std::vector<std::size_t> neighborOffsets;
+        std::vector<std::size_t> neighborEnds;
+        std::vector<std::size_t> mate;
+
+        // indexed by vertex or blossom, blossoms are numbered from numVertices
+        std::vector<std::uint8_t> label;
+        std::vector<std::size_t> labelEnd;
+        std::vector<std::size_t> inBlossom;
+        std::vector<std::size_t> blossomParent;
+        std::vector<std::vector<std::size_t>> blossomChildren;
+        std::vector<std::size_t> blossomBase;
+        std::vector<std::vector<std::size_t>> blossomEndpoints;
+        std::vector<std::size_t> bestEdge;
+        std::vector<std::vector<std::size_t>> blossomBestEdges;
+        std::vector<std::uint8_t> hasBestEdges;
+        std::vector<std::size_t> unusedBlossoms;
+        std::vector<weight_type> dual;
+        std::vector<std::uint8_t> allowEdge;
+        std::vector<std::size_t> queue;
+
+        // scratch, kept to avoid allocating per blossom
+        std::vector<std::size_t> leafStack;
+        std::vector<std::size_t> scanPath;
+        std::vector<std::size_t> bestEdgeTo;
+        std::vector<std::size_t> bestEdgeTouched;
+        std::size_t warmMatches;
+        std::size_t contractions;
+
+        weight_type slack(std::size_t k) const
+        {
+            return dual[endpoint[2 * k]] + dual[endpoint[2 * k + 1]] - 2 * weight[k];
+        }
+
+        // visits the vertices inside b; f must not recurse into forEachLeaf()
+        template<typename F>
+        void forEachLeaf(std::size_t b, F&& f)
+        {
+            leafStack.clear();
+            leafStack.push_back(b);
+            while (!leafStack.empty())
+            {
+                std::size_t t = leafStack.back();
+                leafStack.pop_back();
+                if (t < numVertices)
+                {
+                    f(t);
+                }
+                else
+                {
+                    leafStack.insert(leafStack.end(), blossomChildren[t].crbegin(), blossomChildren[t].crend());
+                }
+            }
+        }
+
+        // children and endpoints are walked cyclically, with python-style negative indices
+        static std::size_t& cyclic(std::vector<std::size_t>& values, std::ptrdiff_t i)
+        {
+            auto size = static_cast<std::ptrdiff_t>(values.size());
+            return values[static_cast<std::size_t>((i % size + size) % size)];
+        }
+
+        static std::ptrdiff_t indexOf(const std::vector<std::size_t>& values, std::size_t x)
+        {
+            return std::find(values.cbegin(), values.cend(), x) - values.cbegin();
+        }
+
+        void assignLabel(std::size_t w, std::uint8_t t, std::size_t p)
+        {
+            std::size_t b = inBlossom[w];
+            label[w] = label[b] = t;
+            labelEnd[w] = labelEnd[b] = p;
+            bestEdge[w] = bestEdge[b] = none;
+            if (t == even)
+            {
+                forEachLeaf(b, [this](std::size_t v) { queue.push_back(v); });
+            }
+            else
+            {
+                std::size_t base = blossomBase[b];
+                assignLabel(endpoint[mate[base]], even, mate[base] ^ 1);
+            }
+        }
+
+        // walks up from the even blossoms of v and w in turn, returning the base of the
+        // new blossom where the walks meet, or none if they reach two different roots
+        std::size_t scanBlossom(std::size_t v, std::size_t w)
+        {
+            scanPath.clear();
+            std::size_t base = none;
+            while (v != none || w != none)
+            {
+                std::size_t b = inBlossom[v];
+                if (label[b] & breadcrumb)
+                {
+                    base = blossomBase[b];
+                    break;
+                }
+
+                scanPath.push_back(b);
+                label[b] = even | breadcrumb;
+                if (labelEnd[b] == none)
+                {
+                    v = none;
+                }
+                else
+                {
+                    v = endpoint[labelEnd[b]];
+                    b = inBlossom[v];
+                    v = endpoint[labelEnd[b]];
+                }
+
+                if (w != none)
+                {
+                    std::swap(v, w);
+                }
+            }
+
+            for (const auto& b : scanPath)
+            {
+                label[b] = even;
+            }
+
+            return base;
+        }
+
+        void addBlossom(std::size_t base, std::size_t k)
+        {
+            ++contractions;
+            std::size_t v = endpoint[2 * k];
+            std::size_t w = endpoint[2 * k + 1];
+            std::size_t bb = inBlossom[base];
+            std::size_t bv = inBlossom[v];
+            std::size_t bw = inBlossom[w];
+            std::size_t b = unusedBlossoms.back();
+            unusedBlossoms.pop_back();
+            blossomBase[b] = base;
+            blossomParent[b] = none;
+            blossomParent[bb] = b;
+
+            auto& children = blossomChildren[b];
+            auto& endpoints = blossomEndpoints[b];
+            children.clear();
+            endpoints.clear();
+            while (bv != bb)
+            {
+                blossomParent[bv] = b;
+                children.push_back(bv);
+                endpoints.push_back(labelEnd[bv]);
+                v = endpoint[labelEnd[bv]];
+                bv = inBlossom[v];
+            }
+
+            children.push_back(bb);
+            std::reverse(children.begin(), children.end());
+            std::reverse(endpoints.begin(), endpoints.end());
+            endpoints.push_back(2 * k);
+            while (bw != bb)
+            {
+                blossomParent[bw] = b;
+                children.push_back(bw);
+                endpoints.push_back(labelEnd[bw] ^ 1);
+                w = endpoint[labelEnd[bw]];
+                bw = inBlossom[w];
+            }
+
+            label[b] = even;
+            labelEnd[b] = labelEnd[bb];
+            dual[b] = 0;
+            forEachLeaf(b, [this, b](std::size_t x)
+            {
+                if (label[inBlossom[x]] == odd)
+                {
+                    queue.push_back(x);
+                }
+
+                inBlossom[x] = b;
+            });
+
+            // the least slack edge from the new blossom to every other even blossom
+            auto consider = [this, b](std::size_t e)
+            {
+                std::size_t j = inBlossom[endpoint[2 * e]] == b ? endpoint[2 * e + 1] : endpoint[2 * e];
+                std::size_t bj = inBlossom[j];
+                if (bj != b && label[bj] == even && (bestEdgeTo[bj] == none || slack(e) < slack(bestEdgeTo[bj])))
+                {
+                    if (bestEdgeTo[bj] == none)
+                    {
+                        bestEdgeTouched.push_back(bj);
+                    }
+
+                    bestEdgeTo[bj] = e;
+                }
+            };
+
+            for (const auto& child : children)
+            {
+                if (hasBestEdges[child])
+                {
+                    for (const auto& e : blossomBestEdges[child])
+                    {
+                        consider(e);
+                    }
+                }
+                else
+                {
+                    forEachLeaf(child, [this, &consider](std::size_t x)
+                    {
+                        for (std::size_t i = neighborOffsets[x]; i < neighborOffsets[x + 1]; ++i)
+                        {
+                            consider(neighborEnds[i] / 2);
+                        }
+                    });
+                }
+
+                blossomBestEdges[child].clear();
+                hasBestEdges[child] = 0;
+                bestEdge[child] = none;
+            }
+
+            auto& best = blossomBestEdges[b];
+            best.clear();
+            for (const auto& bj : bestEdgeTouched)
+            {
+                best.push_back(bestEdgeTo[bj]);
+                bestEdgeTo[bj] = none;
+            }
+
+            bestEdgeTouched.clear();
+            hasBestEdges[b] = 1;
+            bestEdge[b] = none;
+            for (const auto& e : best)
+            {
+                if (bestEdge[b] == none || slack(e) < slack(bestEdge[b]))
+                {
+                    bestEdge[b] = e;
+                }
+            }
+        }
+
+        // dissolves b into its children; an odd b mid-stage relabels the children on
+        // the even length path from its entry child to its base
+        void expandBlossom(std::size_t b, bool endStage)
+        {
+            for (const auto& s : blossomChildren[b])
+            {
+                blossomParent[s] = none;
+                if (s < numVertices)
+                {
+                    inBlossom[s] = s;
+                }
+                else if (endStage && dual[s] == 0)
+                {
+                    expandBlossom(s, endStage);
+                }
+                else
+                {
+                    forEachLeaf(s, [this, s](std::size_t x) { inBlossom[x] = s; });
+                }
+            }
+
+            if (!endStage && label[b] == odd)
+            {
+                auto& children = blossomChildren[b];
+                auto& endpoints = blossomEndpoints[b];
+                std::size_t entryChild = inBlossom[endpoint[labelEnd[b] ^ 1]];
+                std::ptrdiff_t j = indexOf(children, entryChild);
+                std::ptrdiff_t step = -1;
+                std::size_t trick = 1;
+                if (j & 1)
+                {
+                    j -= static_cast<std::ptrdiff_t>(children.size());
+                    step = 1;
+                    trick = 0;
+                }
+
+                std::size_t p = labelEnd[b];
+                while (j != 0)
+                {
+                    label[endpoint[p ^ 1]] = unlabeled;
+                    label[endpoint[cyclic(endpoints, j - static_cast<std::ptrdiff_t>(trick)) ^ trick ^ 1]] = unlabeled;
+                    assignLabel(endpoint[p ^ 1], odd, p);
+                    allowEdge[cyclic(endpoints, j - static_cast<std::ptrdiff_t>(trick)) / 2] = 1;
+                    j += step;
+                    p = cyclic(endpoints, j - static_cast<std::ptrdiff_t>(trick)) ^ trick;
+                    allowEdge[p / 2] = 1;
+                    j += step;
+                }
+
+                std::size_t bv = cyclic(children, j);
+                label[endpoint[p ^ 1]] = label[bv] = odd;
+                labelEnd[endpoint[p ^ 1]] = labelEnd[bv] = p;
+                bestEdge[bv] = none;
+                j += step;
+                while (cyclic(children, j) != entryChild)
+                {
+                    bv = cyclic(children, j);
+                    j += step;
+                    if (label[bv] == even)
+                    {
+                        continue;
+                    }
+
+                    // a child reached from outside through one of its vertices keeps that label
+                    std::size_t reached = none;
+                    forEachLeaf(bv, [this, &reached](std::size_t x)
+                    {
+                        if (reached == none && label[x] != unlabeled)
+                        {
+                            reached = x;
+                        }
+                    });
+
+                    if (reached != none)
+                    {
+                        label[reached] = unlabeled;
+                        label[endpoint[mate[blossomBase[bv]]]] = unlabeled;
+                        assignLabel(reached, odd, labelEnd[reached]);
+                    }
+                }
+            }
+
+            label[b] = unlabeled;
+            labelEnd[b] = none;
+            blossomChildren[b].clear();
+            blossomEndpoints[b].clear();
+            blossomBase[b] = none;
+            blossomBestEdges[b].clear();
+            hasBestEdges[b] = 0;
+            bestEdge[b] = none;
+            unusedBlossoms.push_back(b);
+        }
+
+        // flips the matching inside b so that vertex v becomes its base
+        void augmentBlossom(std::size_t b, std::size_t v)
+        {
+            std::size_t t = v;
+            while (blossomParent[t] != b)
+            {
+                t = blossomParent[t];
+            }
+
+            if (t >= numVertices)
+            {
+                augmentBlossom(t, v);
+            }
+
+            auto& children = blossomChildren[b];
+            auto& endpoints = blossomEndpoints[b];
+            std::ptrdiff_t i = indexOf(children, t);
+            std::ptrdiff_t j = i;
+            std::ptrdiff_t step = -1;
+            std::size_t trick = 1;
+            if (j & 1)
+            {
+                j -= static_cast<std::ptrdiff_t>(children.size());
+                step = 1;
+                trick = 0;
+            }
+
+            while (j != 0)
+            {
+                j += step;
+                t = cyclic(children, j);
+                std::size_t p = cyclic(endpoints, j - static_cast<std::ptrdiff_t>(trick)) ^ trick;
+                if (t >= numVertices)
+                {
+                    augmentBlossom(t, endpoint[p]);
+                }
+
+                j += step;
+                t = cyclic(children, j);
+                if (t >= numVertices)
+                {
+                    augmentBlossom(t, endpoint[p ^ 1]);
+                }
+
+                mate[endpoint[p]] = p ^ 1;
+                mate[endpoint[p ^ 1]] = p;
+            }
+
+            std::rotate(children.begin(), children.begin() + i, children.end());
+            std::rotate(endpoints.begin(), endpoints.begin() + i, endpoints.end());
+            blossomBase[b] = blossomBase[children[0]];
+        }
+
+        void augmentMatching(std::size_t k)
+        {
+            for (auto [s, p] : {std::pair<std::size_t, std::size_t>{endpoint[2 * k], 2 * k + 1},
+                std::pair<std::size_t, std::size_t>{endpoint[2 * k + 1], 2 * k}})
+            {
+                while (true)
+                {
+                    std::size_t bs = inBlossom[s];
+                    if (bs >= numVertices)
+                    {
+                        augmentBlossom(bs, s);
+                    }
+
+                    mate[s] = p;
+                    if (labelEnd[bs] == none)
+                    {
+                        break;
+                    }
+
+                    std::size_t bt = inBlossom[endpoint[labelEnd[bs]]];
+                    s = endpoint[labelEnd[bt]];
+                    std::size_t j = endpoint[labelEnd[bt] ^ 1];
+                    if (bt >= numVertices)
+                    {
+                        augmentBlossom(bt, j);
+                    }
+
+                    mate[j] = labelEnd[bt];
+                    p = labelEnd[bt] ^ 1;
+                }
+            }
+        }
+
+        // one stage grows alternating trees over tight edges from every free vertex,
+        // adjusting duals until an augmenting path appears or none can
+        bool stage()
+        {
+            std::fill(label.begin(), label.end(), unlabeled);
+            std::fill(bestEdge.begin(), bestEdge.end(), none);
+            for (std::size_t b = numVertices; b < 2 * numVertices; ++b)
+            {
+                blossomBestEdges[b].clear();
+                hasBestEdges[b] = 0;
+            }
+
+            std::fill(allowEdge.begin(), allowEdge.end(), 0);
+            queue.clear();
+            for (std::size_t v = 0; v < numVertices; ++v)
+            {
+                if (mate[v] == none && label[inBlossom[v]] == unlabeled)
+                {
+                    assignLabel(v, even, none);
+                }
+            }
+
+            while (true)
+            {
+                while (!queue.empty())
+                {
+                    std::size_t v = queue.back();
+                    queue.pop_back();
+                    for (std::size_t i = neighborOffsets[v]; i < neighborOffsets[v + 1]; ++i)
+                    {
+                        std::size_t p = neighborEnds[i];
+                        std::size_t k = p / 2;
+                        std::size_t w = endpoint[p];
+                        if (inBlossom[v] == inBlossom[w])
+                        {
+                            continue;
+                        }
+
+                        weight_type kslack = 0;
+                        if (!allowEdge[k])
+                        {
+                            kslack = slack(k);
+                            allowEdge[k] = kslack <= 0;
+                        }
+
+                        if (allowEdge[k])
+                        {
+                            if (label[inBlossom[w]] == unlabeled)
+                            {
+                                assignLabel(w, odd, p ^ 1);
+                            }
+                            else if (label[inBlossom[w]] == even)
+                            {
+                                std::size_t base = scanBlossom(v, w);
+                                if (base == none)
+                                {
+                                    augmentMatching(k);
+                                    return true;
+                                }
+
+                                addBlossom(base, k);
+                            }
+                            else if (label[w] == unlabeled)
+                            {
+                                // w sits in an odd blossom but was not reached itself yet
+                                label[w] = odd;
+                                labelEnd[w] = p ^ 1;
+                            }
+                        }
+                        else if (label[inBlossom[w]] == even)
+                        {
+                            std::size_t b = inBlossom[v];
+                            if (bestEdge[b] == none || kslack < slack(bestEdge[b]))
+                            {
+                                bestEdge[b] = k;
+                            }
+                        }
+                        else if (label[w] == unlabeled)
+                        {
+                            if (bestEdge[w] == none || kslack < slack(bestEdge[w]))
+                            {
+                                bestEdge[w] = k;
+                            }
+                        }
+                    }
+                }
+
+                // the largest dual change that keeps every slack non-negative: to a free
+                // vertex, between even blossoms, or down to zero on an odd blossom
+                enum { stop, toFree, betweenEven, expandOdd } deltaType = stop;
+                weight_type delta = 0;
+                std::size_t deltaEdge = none;
+                std::size_t deltaBlossom = none;
+                for (std::size_t v = 0; v < numVertices; ++v)
+                {
+                    if (label[inBlossom[v]] == unlabeled && bestEdge[v] != none)
+                    {
+                        weight_type d = slack(bestEdge[v]);
+                        if (deltaType == stop || d < delta)
+                        {
+                            delta = d;
+                            deltaType = toFree;
+                            deltaEdge = bestEdge[v];
+                        }
+                    }
+                }
+
+                for (std::size_t b = 0; b < 2 * numVertices; ++b)
+                {
+                    if (blossomParent[b] == none && label[b] == even && bestEdge[b] != none)
+                    {
+                        weight_type d = slack(bestEdge[b]) / 2;
+                        if (deltaType == stop || d < delta)
+                        {
+                            delta = d;
+                            deltaType = betweenEven;
+                            deltaEdge = bestEdge[b];
+                        }
+                    }
+                }
+
+                for (std::size_t b = numVertices; b < 2 * numVertices; ++b)
+                {
+                    if (blossomBase[b] != none && blossomParent[b] == none && label[b] == odd
+                        && (deltaType == stop || dual[b] < delta))
+                    {
+                        delta = dual[b];
+                        deltaType = expandOdd;
+                        deltaBlossom = b;
+                    }
+                }
+
+                if (deltaType == stop)
+                {
+                    // no further augmenting path; a last uniform change makes the duals optimal
+                    delta = std::max<weight_type>(0, *std::min_element(dual.cbegin(), dual.cbegin()
+                        + static_cast<std::ptrdiff_t>(numVertices)));
+                }
+
+                for (std::size_t v = 0; v < numVertices; ++v)
+                {
+                    if (label[inBlossom[v]] == even)
+                    {
+                        dual[v] -= delta;
+                    }
+                    else if (label[inBlossom[v]] == odd)
+                    {
+                        dual[v] += delta;
+                    }
+                }
+
+                for (std::size_t b = numVertices; b < 2 * numVertices; ++b)
+                {
+                    if (blossomBase[b] != none && blossomParent[b] == none)
+                    {
+                        if (label[b] == even)
+                        {
+                            dual[b] += delta;
+                        }
+                        else if (label[b] == odd)
+                        {
+                            dual[b] -= delta;
+                        }
+                    }
+                }
+
+                switch (deltaType)
+                {
+                    case stop:
+                        return false;
+                    case toFree:
+                    {
+                        allowEdge[deltaEdge] = 1;
+                        std::size_t i = endpoint[2 * deltaEdge];
+                        queue.push_back(label[inBlossom[i]] == unlabeled ? endpoint[2 * deltaEdge + 1] : i);
+                        break;
+                    }
+                    case betweenEven:
+                        allowEdge[deltaEdge] = 1;
+                        queue.push_back(endpoint[2 * deltaEdge]);
+                        break;
+                    case expandOdd:
+                        expandBlossom(deltaBlossom, false);
+                        break;
+                }
+            }
+        }
+
+    public:
+        // edgeData holds endpoint pairs back to back and weights one entry per pair;
+        // self-loops are ignored, weights should stay well inside +-2^60
+        weighted_matching(std::span<const T> edgeData, std::span<const weight_type> weights): numVertices(0),
+            warmMatches(0), contractions(0)
+        {
+            std::size_t numEdges = std::min(edgeData.size() / 2, weights.size());
+            weight_type maxWeight = std::numeric_limits<weight_type>::min();
+            for (std::size_t k = 0; k < numEdges; ++k)
+            {
+                numVertices = std::max({numVertices, static_cast<std::size_t>(edgeData[2 * k]) + 1,
+                    static_cast<std::size_t>(edgeData[2 * k + 1]) + 1});
+                maxWeight = std::max(maxWeight, weights[k]);
+            }
+
+            // maximising maxWeight - w over matchings of fixed size minimises w
+            neighborOffsets.assign(numVertices + 1, 0);
+            for (std::size_t k = 0; k < numEdges; ++k)
+            {
+                if (edgeData[2 * k] != edgeData[2 * k + 1])
+                {
+                    endpoint.push_back(edgeData[2 * k]);
+                    endpoint.push_back(edgeData[2 * k + 1]);
+                    weight.push_back(maxWeight - weights[k]);
+                    ++neighborOffsets[edgeData[2 * k] + 1];
+                    ++neighborOffsets[edgeData[2 * k + 1] + 1];
+                }
+            }
+
+            for (std::size_t v = 1; v < neighborOffsets.size(); ++v)
+            {
+                neighborOffsets[v] += neighborOffsets[v - 1];
+            }
+
+            neighborEnds.resize(endpoint.size());
+            std::vector<std::size_t> fill(neighborOffsets.cbegin(), neighborOffsets.cend() - 1);
+            for (std::size_t k = 0; k < weight.size(); ++k)
+            {
+                neighborEnds[fill[endpoint[2 * k]]++] = 2 * k + 1;
+                neighborEnds[fill[endpoint[2 * k + 1]]++] = 2 * k;
+            }
+
+            std::size_t n = numVertices;
+            weight_type initialDual = std::max<weight_type>(0, weight.empty() ? 0 : *std::max_element(weight.cbegin(), weight.cend()));
+            mate.assign(n, none);
+            label.assign(2 * n, unlabeled);
+            labelEnd.assign(2 * n, none);
+            inBlossom.resize(n);
+            blossomParent.assign(2 * n, none);
+            blossomChildren.resize(2 * n);
+            blossomBase.assign(2 * n, none);
+            blossomEndpoints.resize(2 * n);
+            bestEdge.assign(2 * n, none);
+            blossomBestEdges.resize(2 * n);
+            hasBestEdges.assign(2 * n, 0);
+            dual.assign(2 * n, 0);
+            allowEdge.assign(weight.size(), 0);
+            bestEdgeTo.assign(2 * n, none);
+            for (std::size_t v = 0; v < n; ++v)
+            {
+                inBlossom[v] = v;
+                blossomBase[v] = v;
+                dual[v] = initialDual;
+                unusedBlossoms.push_back(2 * n - 1 - v);
+            }
+
+            // every edge of the lightest input weight starts tight, and matching those
+            // greedily keeps the duals feasible, so only the rest needs stages
+            std::vector<T> tightEdges;
+            for (std::size_t k = 0; k < weight.size(); ++k)
+            {
+                if (slack(k) == 0)
+                {
+                    tightEdges.push_back(endpoint[2 * k]);
+                    tightEdges.push_back(endpoint[2 * k + 1]);
+                }
+            }
+
+            auto greedy = greedyMatching(csr_graph<T>(std::span<const T>(tightEdges)));
+            for (std::size_t v = 0; v < greedy.size(); ++v)
+            {
+                for (std::size_t i = neighborOffsets[v]; i < neighborOffsets[v + 1] && greedy[v] != npos; ++i)
+                {
+                    std::size_t p = neighborEnds[i];
+                    if (endpoint[p] == greedy[v] && mate[v] == none && slack(p / 2) == 0)
+                    {
+                        mate[v] = p;
+                        mate[endpoint[p]] = p ^ 1;
+                        ++warmMatches;
+                    }
+                }
+            }
+        }
+
+        weighted_matching(const weighted_matching&) = delete;
+        weighted_matching& operator=(const weighted_matching&) = delete;
+
+        // stages until one ends without augmenting, returns the number of augmentations
+        std::size_t run()
+        {
+            std::size_t augmentations = 0;
+            // without edges there is nothing to search, and no dual to take the minimum of
+            while (numVertices != 0 && stage())
+            {
+                ++augmentations;
+                for (std::size_t b = numVertices; b < 2 * numVertices; ++b)
+                {
+                    if (blossomParent[b] == none && blossomBase[b] != none && label[b] == even && dual[b] == 0)
+                    {
+                        expandBlossom(b, true);
+                    }
+                }
+            }
+
+            return augmentations;
+        }
+
+        std::size_t greedy_matches() const
+        {
+            return warmMatches;
+        }
+
+        std::size_t num_contractions() const
+        {
+            return contractions;
+        }
+
+        std::vector<node_type> mates() const
+        {
+            std::vector<node_type> ret(numVertices, npos);
+            for (std::size_t v = 0; v < numVertices; ++v)
+            {
+                if (mate[v] != none)
+                {
+                    ret[v] = endpoint[mate[v]];
+                }
+            }
+
+            return ret;
+        }
+};
+
+#endif